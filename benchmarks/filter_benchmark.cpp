@@ -0,0 +1,62 @@
+// Cost of log calls that are filtered out before anything is enqueued:
+// below the global level, below a category's level, and while the logger is stopped.
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <filesystem>
+
+#include <slick/logger.hpp>
+
+using namespace std::chrono;
+using namespace slick::logger;
+
+template<typename F>
+double ns_per_call(size_t iterations, F&& call) {
+    // Warm up
+    for (size_t i = 0; i < iterations / 10; ++i) {
+        call(i);
+    }
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        call(i);
+    }
+    auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    return static_cast<double>(elapsed) / iterations;
+}
+
+int main() {
+    constexpr size_t iterations = 100'000'000;
+
+    std::cout << "Filtered-out log call cost (" << iterations << " calls each)\n";
+    std::cout << "===========================================\n";
+    std::cout << std::fixed << std::setprecision(2);
+
+    auto& logger = Logger::instance();
+    logger.reset();
+    logger.add_file_sink("bench_filter.log");
+    logger.init(8192);
+    logger.set_level(LogLevel::L_INFO);
+
+    double below_level = ns_per_call(iterations, [](size_t i) {
+        LOG_DEBUG("Filtered message {} value: {:.3f}", i, i * 1.618);
+    });
+    std::cout << "Below global level:   " << below_level << " ns/call\n";
+
+    logger.set_level(LogLevel::L_TRACE);
+    logger.set_category_levels("bench.*=WARN");
+    auto& category = logger.category("bench.filter");
+    double below_category = ns_per_call(iterations, [&category](size_t i) {
+        LOG_CAT_INFO(category, "Filtered message {} value: {:.3f}", i, i * 1.618);
+    });
+    std::cout << "Below category level: " << below_category << " ns/call\n";
+
+    logger.shutdown();
+    double stopped = ns_per_call(iterations, [](size_t i) {
+        LOG_ERROR("Filtered message {} value: {:.3f}", i, i * 1.618);
+    });
+    std::cout << "Logger stopped:       " << stopped << " ns/call\n";
+
+    logger.reset();
+    std::filesystem::remove("bench_filter.log");
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Reads the shared-memory ring written by ShmRingSink and prints it to stdout.
+//
+// Usage: slick_log_tail <shm-name> [--from-start]
+//   --from-start  Begin with the oldest record still locatable (after a wrap, the start of
+//                 the ring's current lap) instead of new records only
+//
+// Run it next to a process that logs through Logger::add_shm_ring_sink(). Because the
+// ring lives in shared memory, the tail keeps draining records after the writer exits.
+#include <iostream>
+#include <slick/logger.hpp>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+
+using namespace slick::logger;
+
+namespace {
+volatile std::sig_atomic_t stop_requested = 0;
+void on_signal(int) { stop_requested = 1; }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <shm-name> [--from-start]\n"
+                  << "  --from-start  begin with the oldest locatable record (after a wrap, the start of the current lap)\n";
+        return 1;
+    }
+    bool from_start = argc > 2 && std::strcmp(argv[2], "--from-start") == 0;
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    try {
+        ShmRingReader reader(argv[1], from_start);
+        ShmRingReader::Record record;
+        TimestampFormatter formatter(TimestampFormatter::Format::WITH_MICROSECONDS);
+        uint64_t reported_lost = 0;
+
+        while (!stop_requested) {
+            if (!reader.read(record)) {
+                if (reader.lost_bytes() != reported_lost) {
+                    std::cerr << "slick_log_tail: overrun, skipped " << (reader.lost_bytes() - reported_lost) << " bytes\n";
+                    reported_lost = reader.lost_bytes();
+                }
+                std::cout.flush();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            std::cout << formatter.format_timestamp(record.timestamp) << " [" << to_string(record.level) << "] "
+                      << record.message << '\n';
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "slick_log_tail: " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
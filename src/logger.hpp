@@ -44,6 +44,20 @@
 #include <utility>
 #include <vector>
 #include <string_view>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+#include <cmath>
+#include <bit>
+#include <ranges>
+#include <array>
+#include <unordered_map>
+#include <map>
+#include <optional>
+#include <unordered_set>
 #include <slick/queue.h>
 
 // For time functions on some platforms
@@ -51,6 +65,39 @@
 #include <time.h>
 #endif
 
+// Unbuffered console output
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+// POSIX shared memory for ShmRingSink
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// For lowering the priority of background compression threads
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+// Vectorized JSON string escaping
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SLICK_LOGGER_HAS_SSE2 1
+#endif
+
+// Defined by CMake when zlib is found at configure time
+#ifdef SLICK_LOGGER_HAS_ZLIB
+#include <zlib.h>
+#endif
+
 #define SLICK_LOGGER_VERSION_MAJOR @slick_logger_VERSION_MAJOR@
 #define SLICK_LOGGER_VERSION_MINOR @slick_logger_VERSION_MINOR@
 #define SLICK_LOGGER_VERSION_PATCH @slick_logger_VERSION_PATCH@
@@ -60,6 +107,9 @@
 #define SLICK_LOGGER_MAX_ARGS 20
 #endif
 
+// Sinks are addressed by a 64-bit mask, one bit per sink
+#define SLICK_LOGGER_MAX_SINKS 64
+
 namespace slick::logger {
 
 enum class LogLevel : uint8_t {
@@ -85,6 +135,28 @@ inline constexpr const char* to_string(LogLevel level) noexcept {
     }
 }
 
+/**
+ * @brief Parse a level name as printed by to_string (case-insensitive, WARNING is accepted)
+ * @return The level, or nothing if the name is unknown
+ */
+inline std::optional<LogLevel> level_from_string(std::string_view name) noexcept {
+    auto equals = [name](std::string_view level) {
+        return name.size() == level.size() &&
+            std::equal(name.begin(), name.end(), level.begin(), [](char a, char b) {
+                return (a >= 'a' && a <= 'z' ? char(a - 'a' + 'A') : a) == b;
+            });
+    };
+    for (uint8_t i = 0; i <= static_cast<uint8_t>(LogLevel::L_OFF); ++i) {
+        if (equals(to_string(static_cast<LogLevel>(i)))) {
+            return static_cast<LogLevel>(i);
+        }
+    }
+    if (equals("WARNING")) {
+        return LogLevel::L_WARN;
+    }
+    return std::nullopt;
+}
+
 /**
  * @brief Class to format timestamps in various formats
  */
@@ -168,6 +240,9 @@ public:
         return oss.str();
     }
 
+    Format format() const noexcept { return format_; }
+    const std::string& custom_format() const noexcept { return custom_format_; }
+
 private:
     Format format_;
     std::string custom_format_;
@@ -190,13 +265,27 @@ enum class ArgType : uint8_t {
     DOUBLE,
     PTR,             // pointer types
     STRING_LITERAL,  // const char* - safe to store pointer
-    STRING_DYNAMIC   // std::string - stored in separate queue
+    STRING_DYNAMIC,  // std::string - stored in separate queue
+    STRING_PERSISTENT, // persistent() / intern() - pointer and length stored, never copied
+    BYTES,           // bytes() - raw bytes copied to the string queue, rendered as hex
+    ARRAY,           // contiguous range of arithmetic values copied to the string queue, see ArrayArgument
+    DECIMAL,         // decimal() - scaled integer, rendered exactly without floating point
+    KEY              // kv() key - string literal, the value is the next argument
 };
 
 #pragma pack(push, 1)
 struct StringRef {
-    const char* ptr;    // Pointer to string data
-    uint32_t length;    // String length
+    const char* ptr;            // Pointer to string data
+    uint32_t length : 31;       // String length
+    uint32_t truncated : 1;     // Cut to fit the string queue, rendered with a trailing "..."
+};
+
+/**
+ * @brief Fixed-point decimal, mantissa * 10^exponent, see decimal()
+ */
+struct Decimal {
+    int64_t mantissa;
+    int8_t exponent;
 };
 
 struct LogArgument {
@@ -219,6 +308,7 @@ struct LogArgument {
         void* ptr;             // For pointer types
         const char* literal_ptr;  // For string literals
         StringRef dynamic_str;    // For dynamic strings
+        Decimal decimal;          // For decimal()
     } value;
 };
 
@@ -226,12 +316,529 @@ struct LogEntry {
     LogLevel level;
     const char* format_ptr; // Format string
     uint64_t timestamp; // nanoseconds since epoch
-    int sink_index = -1; // Optional sink index, logged by that sink only
+    uint64_t sink_mask = 0; // Target sinks, one bit per sink index. 0 logs to all non-dedicated sinks
+    uint32_t context_id = 0; // Thread context at the call site, see ScopedContext. 0 for none
+    uint32_t thread_id = 0; // Dense id of the logging thread, see current_thread_id()
     uint8_t arg_count = 0; // Number of arguments
     LogArgument args[SLICK_LOGGER_MAX_ARGS];
 };
 #pragma pack(pop)
 
+/**
+ * @brief String argument that outlives the logger, such as static tables or interned strings
+ * Only its pointer and length are enqueued; the characters are never copied.
+ */
+struct PersistentString {
+    std::string_view value;
+};
+
+/**
+ * @brief Mark a string argument as persistent, to log it without copying
+ * The caller guarantees the characters stay valid until the logger has written the entry.
+ */
+inline constexpr PersistentString persistent(std::string_view str) noexcept {
+    return PersistentString{str};
+}
+
+/**
+ * @brief Process-wide registry of interned strings
+ * Interned strings are never freed, so they can be logged with persistent() semantics.
+ */
+class StringRegistry {
+public:
+    static StringRegistry& instance() {
+        static StringRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief Intern a string
+     * @return A persistent reference to the registry's copy, the same for equal strings
+     */
+    PersistentString intern(std::string_view str) {
+        std::lock_guard lock(mutex_);
+        return PersistentString{*strings_.emplace(str).first};
+    }
+
+    size_t size() const {
+        std::lock_guard lock(mutex_);
+        return strings_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_set<std::string> strings_;   // node based, elements never move
+};
+
+/**
+ * @brief Intern a string in the process-wide registry, e.g. symbol names loaded at startup
+ */
+inline PersistentString intern(std::string_view str) {
+    return StringRegistry::instance().intern(str);
+}
+
+/**
+ * @brief Fields of a thread context, see ScopedContext
+ */
+struct LogContext {
+    std::vector<std::pair<std::string, std::string>> fields;
+    std::string text;   // "key=value key2=value2", rendered once for text sinks
+};
+
+/**
+ * @brief Process-wide registry of thread context snapshots
+ * A snapshot is registered when a thread's context changes and is referenced from entries
+ * by its id. Snapshots are deduplicated and counted by the scopes using them. A released
+ * snapshot keeps its slot until the slot is needed again, oldest released first, so entries
+ * still queued normally resolve it; an id whose slot was reused resolves to no context.
+ * When every slot is held by a live scope, push() returns 0 and the scope logs without
+ * context.
+ */
+class ContextRegistry {
+public:
+    static constexpr uint32_t PAGE_SIZE = 1024;
+    static constexpr uint32_t MAX_PAGES = 64;
+    static constexpr uint32_t CAPACITY = PAGE_SIZE * MAX_PAGES;    // slot 0 is not used
+    static constexpr uint32_t SLOT_BITS = 16;                      // id = generation << SLOT_BITS | slot
+    static_assert(CAPACITY == uint32_t(1) << SLOT_BITS);
+
+    static ContextRegistry& instance() {
+        static ContextRegistry registry;
+        return registry;
+    }
+
+    ~ContextRegistry() {
+        for (auto& page : pages_) {
+            delete[] page.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Acquire the id of the context parent extended with key=value, replacing an existing key
+     * @return The id, to be released with release(), or 0 when every slot is in use
+     */
+    uint32_t push(uint32_t parent, std::string_view key, std::string_view value) {
+        std::lock_guard lock(mutex_);
+        std::vector<std::pair<std::string, std::string>> fields;
+        if (Slot* parent_slot = live_slot(parent)) {
+            fields = parent_slot->context->fields;
+        }
+        auto field = std::find_if(fields.begin(), fields.end(), [key](const auto& f) { return f.first == key; });
+        if (field != fields.end()) {
+            field->second = value;
+        } else {
+            fields.emplace_back(key, value);
+        }
+
+        auto existing = ids_.find(fields);
+        if (existing != ids_.end()) {
+            Slot& slot = *slot_at(existing->second & SLOT_MASK);
+            if (slot.refs++ == 0) {
+                unlink(existing->second & SLOT_MASK);   // revived before its slot was reused
+            }
+            return existing->second;
+        }
+
+        uint32_t index = take_slot();
+        if (index == 0) {
+            return 0;
+        }
+        auto context = std::make_shared<LogContext>();
+        for (const auto& [k, v] : fields) {
+            if (!context->text.empty()) {
+                context->text += ' ';
+            }
+            context->text += k;
+            context->text += '=';
+            context->text += v;
+        }
+        context->fields = fields;
+
+        Slot& slot = *slot_at(index);
+        uint32_t id = (++slot.generation << SLOT_BITS) | index;
+        if (id == index) {
+            id = (++slot.generation << SLOT_BITS) | index;   // generation 0 after wrapping
+        }
+        {
+            std::lock_guard slot_lock(slot.mutex);
+            slot.id = id;
+            slot.context = std::move(context);
+        }
+        slot.refs = 1;
+        ids_.emplace(std::move(fields), id);
+        return id;
+    }
+
+    /**
+     * @brief Release an id acquired with push(); 0 is ignored
+     */
+    void release(uint32_t id) noexcept {
+        std::lock_guard lock(mutex_);
+        Slot* slot = live_slot(id);
+        if (slot && slot->refs > 0 && --slot->refs == 0) {
+            // Append to the released list, the tail is reused last
+            uint32_t index = id & SLOT_MASK;
+            Slot& head = *slot_at(0);
+            slot->prev = head.prev;
+            slot->next = 0;
+            slot_at(head.prev)->next = index;
+            head.prev = index;
+        }
+    }
+
+    /**
+     * @brief Look up a context by id
+     * @return The context, or null for id 0 or an id whose slot has been reused
+     */
+    std::shared_ptr<const LogContext> find(uint32_t id) const {
+        uint32_t index = id & SLOT_MASK;
+        if (id == 0 || index == 0) {
+            return nullptr;
+        }
+        Slot* page = pages_[index / PAGE_SIZE].load(std::memory_order_acquire);
+        if (!page) {
+            return nullptr;
+        }
+        Slot& slot = page[index % PAGE_SIZE];
+        std::lock_guard lock(slot.mutex);
+        return slot.id == id ? slot.context : nullptr;
+    }
+
+    /**
+     * @brief Number of snapshots held, live or released but not yet reused
+     */
+    size_t size() const {
+        std::lock_guard lock(mutex_);
+        return ids_.size();
+    }
+
+private:
+    static constexpr uint32_t SLOT_MASK = CAPACITY - 1;
+
+    struct Slot {
+        mutable std::mutex mutex;       // guards id and context against reuse while the writer copies them
+        uint32_t id = 0;
+        std::shared_ptr<const LogContext> context;
+        // Guarded by the registry mutex
+        uint32_t generation = 0;
+        uint32_t refs = 0;
+        uint32_t prev = 0;              // released list, slot 0 is its head
+        uint32_t next = 0;
+    };
+
+    ContextRegistry() {
+        // Slot 0 heads the circular list of released slots
+        pages_[0].store(new Slot[PAGE_SIZE], std::memory_order_release);
+    }
+
+    Slot* slot_at(uint32_t index) const noexcept {
+        return &pages_[index / PAGE_SIZE].load(std::memory_order_relaxed)[index % PAGE_SIZE];
+    }
+
+    // Called with mutex_ held
+    Slot* live_slot(uint32_t id) const noexcept {
+        uint32_t index = id & SLOT_MASK;
+        if (id == 0 || index == 0 || index >= next_slot_) {
+            return nullptr;
+        }
+        Slot* slot = slot_at(index);
+        return slot->id == id ? slot : nullptr;
+    }
+
+    void unlink(uint32_t index) noexcept {
+        Slot& slot = *slot_at(index);
+        slot_at(slot.prev)->next = slot.next;
+        slot_at(slot.next)->prev = slot.prev;
+        slot.prev = slot.next = 0;
+    }
+
+    // A never used slot, else the oldest released one. 0 if all are in use
+    uint32_t take_slot() {
+        if (next_slot_ < CAPACITY) {
+            uint32_t index = next_slot_;
+            if (index % PAGE_SIZE == 0) {
+                pages_[index / PAGE_SIZE].store(new Slot[PAGE_SIZE], std::memory_order_release);
+            }
+            ++next_slot_;
+            return index;
+        }
+        uint32_t index = slot_at(0)->next;
+        if (index == 0) {
+            return 0;
+        }
+        unlink(index);
+        ids_.erase(slot_at(index)->context->fields);
+        return index;
+    }
+
+    mutable std::mutex mutex_;
+    std::map<std::vector<std::pair<std::string, std::string>>, uint32_t> ids_;
+    uint32_t next_slot_ = 1;
+    std::atomic<Slot*> pages_[MAX_PAGES]{};
+};
+
+/**
+ * @brief Process-wide registry of dense thread ids and thread names
+ * Ids are handed out on a thread's first log call. Names are only read by the writer
+ * thread, lock free; a renamed thread keeps its old name string alive.
+ */
+class ThreadRegistry {
+public:
+    static constexpr uint32_t PAGE_SIZE = 256;
+    static constexpr uint32_t MAX_PAGES = 256;
+
+    static ThreadRegistry& instance() {
+        static ThreadRegistry registry;
+        return registry;
+    }
+
+    ~ThreadRegistry() {
+        for (auto& page : pages_) {
+            delete[] page.load(std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t next_id() noexcept {
+        return next_id_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void set_name(uint32_t id, std::string_view name) {
+        if (id == 0 || id >= PAGE_SIZE * MAX_PAGES) {
+            return;
+        }
+        std::lock_guard lock(mutex_);
+        auto* page = pages_[id / PAGE_SIZE].load(std::memory_order_relaxed);
+        if (!page) {
+            page = new std::atomic<const std::string*>[PAGE_SIZE]{};
+            pages_[id / PAGE_SIZE].store(page, std::memory_order_release);
+        }
+        page[id % PAGE_SIZE].store(&names_.emplace_back(name), std::memory_order_release);
+    }
+
+    /**
+     * @return The thread's name, or an empty view if it has none
+     */
+    std::string_view name(uint32_t id) const noexcept {
+        if (id == 0 || id >= PAGE_SIZE * MAX_PAGES) {
+            return {};
+        }
+        auto* page = pages_[id / PAGE_SIZE].load(std::memory_order_acquire);
+        const std::string* name = page ? page[id % PAGE_SIZE].load(std::memory_order_acquire) : nullptr;
+        return name ? std::string_view(*name) : std::string_view();
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<std::string> names_;     // elements never move
+    std::atomic<uint32_t> next_id_{1};  // 0 means unknown
+    std::atomic<std::atomic<const std::string*>*> pages_[MAX_PAGES]{};
+};
+
+namespace detail {
+inline thread_local uint32_t current_context_id = 0;
+inline thread_local uint32_t current_thread_id = 0;
+}
+
+/**
+ * @brief Small dense id of the calling thread, assigned on first use and cached thread_local
+ */
+inline uint32_t current_thread_id() noexcept {
+    uint32_t id = detail::current_thread_id;
+    if (id == 0) [[unlikely]] {
+        id = detail::current_thread_id = ThreadRegistry::instance().next_id();
+    }
+    return id;
+}
+
+/**
+ * @brief Id of the calling thread's current context, 0 if none
+ */
+inline uint32_t current_context_id() noexcept {
+    return detail::current_context_id;
+}
+
+/**
+ * @brief Adds a field to every entry logged by this thread while in scope (MDC)
+ * Scopes nest: an inner scope adds to, or overrides a key of, the enclosing context.
+ * The snapshot is registered on construction; each log call only copies the thread's
+ * current context id into the entry.
+ *
+ *     ScopedContext strategy("strategy", "mm1");
+ *     ScopedContext order("order", order_id);
+ *     LOG_INFO("Sent");   // ... [INFO] [strategy=mm1 order=42] Sent
+ */
+class ScopedContext {
+public:
+    template<typename T>
+    ScopedContext(std::string_view key, const T& value)
+        : previous_(detail::current_context_id) {
+        if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            id_ = ContextRegistry::instance().push(previous_, key, value);
+        } else {
+            id_ = ContextRegistry::instance().push(previous_, key, std::format("{}", value));
+        }
+        detail::current_context_id = id_;
+    }
+
+    ~ScopedContext() {
+        detail::current_context_id = previous_;
+        ContextRegistry::instance().release(id_);
+    }
+
+    ScopedContext(const ScopedContext&) = delete;
+    ScopedContext& operator=(const ScopedContext&) = delete;
+
+private:
+    uint32_t previous_;
+    uint32_t id_ = 0;   // 0 if the registry was full
+};
+
+/**
+ * @brief Raw binary argument, see bytes()
+ */
+struct Bytes {
+    const void* data;
+    size_t size;
+};
+
+/**
+ * @brief Log a binary buffer, e.g. a raw packet
+ * The bytes are copied with one memcpy and rendered as hex by the writer thread:
+ * `{}` or `{:x}` gives lowercase hex, `{:X}` uppercase hex and `{:dump}` a hexdump
+ * with offsets and an ASCII column.
+ */
+inline constexpr Bytes bytes(const void* data, size_t size) noexcept {
+    return Bytes{data, size};
+}
+
+/**
+ * @brief Log a scaled integer such as a price in ticks, e.g. decimal(10125, -2) for 101.25
+ * Only the 9 bytes are stored; the writer thread renders the digits exactly using integer
+ * arithmetic. `{}` prints all -exponent fractional digits, `{:.N}` or `{:.Nf}` rounds or pads
+ * to N digits (half away from zero), and fill, align and width work as for strings.
+ */
+inline constexpr Decimal decimal(int64_t mantissa, int8_t exponent) noexcept {
+    return Decimal{mantissa, exponent};
+}
+
+/**
+ * @brief Named argument, see kv()
+ */
+template<typename T>
+struct KeyValue {
+    const char* key;
+    T value;    // reference for lvalues, so the value is only copied when enqueued
+};
+
+/**
+ * @brief Log a named value, e.g. kv("qty", qty)
+ * The key must be a string literal: only its pointer is stored, in an extra argument slot.
+ * Text sinks render `qty=100`, both for a `{}` placeholder and, after the message, for
+ * named arguments without one. JsonLinesSink writes them as native fields.
+ */
+template<size_t N, typename T>
+inline constexpr KeyValue<T> kv(const char (&key)[N], T&& value) noexcept {
+    return KeyValue<T>{key, std::forward<T>(value)};
+}
+
+template<typename T>
+struct is_key_value : std::false_type {};
+
+template<typename T>
+struct is_key_value<KeyValue<T>> : std::true_type {};
+
+/**
+ * @brief Number of LogArgument slots an argument of type T takes
+ */
+template<typename T>
+inline constexpr uint8_t argument_slots_v = is_key_value<std::remove_cvref_t<T>>::value ? 2 : 1;
+
+/**
+ * @brief Check whether an argument's data lives in the logger's string queue
+ * Sinks that keep entries beyond the write() call must copy these.
+ */
+inline constexpr bool is_queued_data(ArgType type) noexcept {
+    return type == ArgType::STRING_DYNAMIC || type == ArgType::BYTES || type == ArgType::ARRAY;
+}
+
+template<typename T>
+inline constexpr bool is_char_like_v = std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+    std::is_same_v<T, unsigned char> || std::is_same_v<T, wchar_t> || std::is_same_v<T, char8_t> ||
+    std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t>;
+
+/**
+ * @brief Element types that can be logged as an ARRAY argument
+ */
+template<typename T>
+inline constexpr bool is_array_element_v = std::is_arithmetic_v<T> && !is_char_like_v<T> &&
+    !std::is_same_v<T, long double> && sizeof(T) <= sizeof(uint64_t);
+
+/**
+ * @brief Contiguous ranges (std::vector, std::array, std::span, C arrays) of arithmetic values
+ * Such a range is copied as a single ARRAY payload: one ArgType byte for the element type
+ * followed by the raw elements.
+ */
+template<typename R>
+concept ArrayArgument = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    is_array_element_v<std::remove_cv_t<std::ranges::range_value_t<R>>>;
+
+/**
+ * @brief ArgType describing an array element type
+ */
+template<typename T>
+inline constexpr ArgType array_element_type() noexcept {
+    if constexpr (std::is_same_v<T, bool>) return ArgType::BOOL;
+    else if constexpr (std::is_floating_point_v<T>) return sizeof(T) == sizeof(float) ? ArgType::FLOAT : ArgType::DOUBLE;
+    else if constexpr (std::is_signed_v<T>) {
+        if constexpr (sizeof(T) == 1) return ArgType::INT8_T;
+        else if constexpr (sizeof(T) == 2) return ArgType::INT16_T;
+        else if constexpr (sizeof(T) == 4) return ArgType::INT32_T;
+        else return ArgType::INT64_T;
+    }
+    else {
+        if constexpr (sizeof(T) == 1) return ArgType::UINT8_T;
+        else if constexpr (sizeof(T) == 2) return ArgType::UINT16_T;
+        else if constexpr (sizeof(T) == 4) return ArgType::UINT32_T;
+        else return ArgType::UINT64_T;
+    }
+}
+
+/**
+ * @brief Call f with each element of an ARRAY payload, as its original type
+ * Elements are read with memcpy since the payload is not aligned.
+ */
+template<typename F>
+inline void for_each_array_element(const StringRef& payload, F&& f) {
+    if (payload.length == 0) {
+        return;
+    }
+    const char* data = payload.ptr + 1;
+    const size_t size = payload.length - 1;
+    auto each = [&]<typename T>() {
+        for (size_t offset = 0; offset + sizeof(T) <= size; offset += sizeof(T)) {
+            T value;
+            std::memcpy(&value, data + offset, sizeof(T));
+            f(value);
+        }
+    };
+    switch (static_cast<ArgType>(payload.ptr[0])) {
+        case ArgType::BOOL:     each.template operator()<bool>(); break;
+        case ArgType::INT8_T:   each.template operator()<int8_t>(); break;
+        case ArgType::INT16_T:  each.template operator()<int16_t>(); break;
+        case ArgType::INT32_T:  each.template operator()<int32_t>(); break;
+        case ArgType::INT64_T:  each.template operator()<int64_t>(); break;
+        case ArgType::UINT8_T:  each.template operator()<uint8_t>(); break;
+        case ArgType::UINT16_T: each.template operator()<uint16_t>(); break;
+        case ArgType::UINT32_T: each.template operator()<uint32_t>(); break;
+        case ArgType::UINT64_T: each.template operator()<uint64_t>(); break;
+        case ArgType::FLOAT:    each.template operator()<float>(); break;
+        case ArgType::DOUBLE:   each.template operator()<double>(); break;
+        default: break;
+    }
+}
+
+class Logger;
+
 class ISink {
 public:
     ISink(std::string&& name = "") : name_(std::move(name)) {}
@@ -239,14 +846,20 @@ public:
     virtual void write(const LogEntry& entry) = 0;
     virtual void flush() = 0;
 
-    void set_min_level(LogLevel level) noexcept { min_level_ = level; }
-    LogLevel min_level() const noexcept { return min_level_; }
+    /**
+     * @brief Set the minimum level this sink writes, also while the logger is running
+     * @param level Minimum LogLevel
+     * @throws std::bad_alloc or std::system_error if the logger's routing table cannot be rebuilt
+     */
+    void set_min_level(LogLevel level);
+    LogLevel min_level() const noexcept { return min_level_.load(std::memory_order_relaxed); }
 
     /**
      * @brief Set whether this sink is dedicated (logs only its own entries)
      * @param dedicated True to make the sink dedicated, false otherwise
+     * @throws std::bad_alloc or std::system_error if the logger's routing table cannot be rebuilt
      */
-    void set_dedicated(bool dedicated) noexcept { dedicated_ = dedicated; }
+    void set_dedicated(bool dedicated);
 
     /**
      * @brief Check if this sink is dedicated (logs only its own entries)
@@ -285,43 +898,282 @@ public:
 
     int index() const noexcept { return index_; }
     void set_index(int idx) noexcept { index_ = idx; }
+
+    /**
+     * @brief Logger this sink was added to
+     * @return The owning logger, or null if the sink is not attached
+     */
+    Logger* logger() const noexcept { return logger_; }
+
+    /**
+     * @brief Routing bit of this sink, for Logger::log_to_sinks
+     * @return The sink's bit, or 0 if the sink was not added to a Logger
+     */
+    uint64_t mask() const noexcept { return index_ >= 0 ? uint64_t(1) << index_ : 0; }
 protected:
+    friend class Logger;
+    friend class PatternLayout;
+
     std::pair<std::string, bool> format_log_message(const LogEntry& entry);
 
+    /**
+     * @brief Format the entry's message, appending it to out
+     * Lets sinks render into a reused buffer without allocating per entry.
+     * @return False if formatting failed; out then holds an error message instead
+     */
+    bool format_log_message(const LogEntry& entry, std::string& out);
+
+    /**
+     * @brief Format one argument with a replacement field such as `{:.2f}`, appending it to out
+     * @throws std::format_error if the spec does not apply to the argument
+     */
+    static void format_argument(const LogArgument& arg, std::string_view format_spec, std::string& out);
+
+    /**
+     * @brief Append the entry's thread name as "[name] ", if the thread was named
+     */
+    static void append_thread(const LogEntry& entry, std::string& out);
+
+    /**
+     * @brief Append the entry's thread context as "[key=value ...] ", if it has one
+     */
+    static void append_context(const LogEntry& entry, std::string& out);
+
 protected:
     std::string name_;
     int index_ = -1; // Index assigned by Logger when added
-    LogLevel min_level_ = LogLevel::L_TRACE; // Minimum level for this sink
+    Logger* logger_ = nullptr; // Logger the sink was added to
+    std::atomic<LogLevel> min_level_{LogLevel::L_TRACE}; // Minimum level, may be read by another thread (AsyncSink)
     bool dedicated_ = false; // Whether this sink is dedicated (logs only its own entries)
 };
 
 struct RotationConfig {
     size_t max_file_size = 10 * 1024 * 1024; // 10MB
     size_t max_files = 5;
-    bool compress_old = false;
+    bool compress_old = false; // gzip rotated files in the background (requires zlib)
     std::chrono::hours rotation_hour = std::chrono::hours(0); // Daily at midnight
 };
 
-class ConsoleSink : public ISink {
+/**
+ * @brief Lower the CPU and I/O priority of the calling thread (Linux only)
+ */
+void lower_current_thread_priority() noexcept;
+
+/**
+ * @brief Runs file housekeeping tasks in order on a low-priority background thread
+ * Pending tasks are drained on destruction.
+ */
+class BackgroundWorker {
 public:
-    explicit ConsoleSink(bool use_colors = true, bool use_stderr_for_errors = true,
-                         TimestampFormatter::Format timestamp_format = TimestampFormatter::Format::WITH_MICROSECONDS,
-                         std::string&& name = "");
-    
-    explicit ConsoleSink(const std::string& custom_timestamp_format, bool use_colors = true, 
-                        bool use_stderr_for_errors = true, std::string&& name = "");
+    BackgroundWorker();
+    ~BackgroundWorker();
 
+    BackgroundWorker(const BackgroundWorker&) = delete;
+    BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+
+    /**
+     * @brief Queue a task to run on the worker thread
+     * @param task Task to run
+     */
+    void post(std::function<void()> task);
+
+private:
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+/**
+ * @brief Compresses rotated log files to gzip on a low-priority background thread
+ *
+ * Each file is compressed into `<file>.gz.tmp` and renamed to `<file>.gz` once complete,
+ * so readers never see a partial archive. Requires zlib (SLICK_LOGGER_HAS_ZLIB).
+ */
+class BackgroundCompressor {
+public:
+    BackgroundCompressor();
+    ~BackgroundCompressor();
+
+    BackgroundCompressor(const BackgroundCompressor&) = delete;
+    BackgroundCompressor& operator=(const BackgroundCompressor&) = delete;
+
+    /**
+     * @brief Check whether compression support was compiled in
+     * @return True if zlib is available
+     */
+    static constexpr bool available() noexcept {
+#ifdef SLICK_LOGGER_HAS_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Queue a rotated file for compression
+     * @param file Path of the file to compress; it is replaced by `<file>.gz`
+     */
+    void submit(const std::filesystem::path& file);
+
+    /**
+     * @brief Follow a rotated file that was renamed or removed while queued or being compressed
+     * Must be called with mutex() held.
+     * @param from Previous path of the file
+     * @param to New path of the file, or empty if the file was removed
+     */
+    void retarget(const std::filesystem::path& from, const std::filesystem::path& to);
+
+    /**
+     * @brief Check whether a file is queued or currently being compressed
+     * @param file Path of the file
+     * @return True if the file will become `<file>.gz`
+     */
+    bool contains(const std::filesystem::path& file) const;
+
+    /**
+     * @brief Mutex guarding rotated file names, held by sinks while they rotate files
+     */
+    std::mutex& mutex() noexcept { return mutex_; }
+
+    static std::filesystem::path archive_path(const std::filesystem::path& file) {
+        return std::filesystem::path(file) += ".gz";
+    }
+
+    /**
+     * @brief Create a compressor for a rotating sink
+     * @return A compressor if config.compress_old is set and zlib is available, otherwise null
+     */
+    static std::unique_ptr<BackgroundCompressor> create(const RotationConfig& config) {
+        if (config.compress_old && available()) {
+            return std::make_unique<BackgroundCompressor>();
+        }
+        return nullptr;
+    }
+
+private:
+    void run();
+    bool compress_file(const std::filesystem::path& src, const std::filesystem::path& dst);
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::filesystem::path> pending_;
+    std::filesystem::path in_flight_; // Current location of the file being compressed
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+// Helpers for rotating sinks: operate on a rotated file and its `.gz` archive together
+// and keep queued compression jobs pointing at the right file. compressor may be null.
+bool rotated_file_exists(const std::filesystem::path& file, const BackgroundCompressor* compressor);
+void rename_rotated_file(const std::filesystem::path& src, const std::filesystem::path& dst, BackgroundCompressor* compressor);
+void remove_rotated_file(const std::filesystem::path& file, BackgroundCompressor* compressor);
+
+/**
+ * @brief Line layout for text sinks, compiled once into a list of ops
+ *
+ * Pattern flags:
+ *   %Y %m %d %H %M %S  year, month, day, hour, minute, second (local time)
+ *   %F %T              %Y-%m-%d and %H:%M:%S
+ *   %e %f %N           milliseconds, microseconds, nanoseconds within the second
+ *   %l                 level
+ *   %t                 thread name, or the thread id if the thread is unnamed
+ *   %X                 thread context fields, key=value separated by spaces
+ *   %n                 sink name
+ *   %v                 message
+ *   %%                 a literal %
+ *
+ * The broken-down time is cached per second, so date flags cost a few digit copies.
+ * Not thread safe; each sink owns its layout and uses it from the writer thread.
+ */
+class PatternLayout {
+public:
+    /**
+     * @brief Compile a pattern such as "%F %T.%f [%l] [%t] %v"
+     * @throws std::runtime_error on an unknown flag
+     */
+    explicit PatternLayout(std::string_view pattern);
+
+    /**
+     * @brief The built-in layout: "<timestamp> [<level>] [<thread name>] [<context>] <message>"
+     * The timestamp is compiled into the same cached date ops as a pattern, with the text of
+     * TimestampFormatter::format_timestamp (a custom %f is zero padded). The thread name and
+     * context are only printed when present.
+     */
+    explicit PatternLayout(TimestampFormatter timestamp_formatter = TimestampFormatter());
+
+    /**
+     * @brief Render the entry for sink, appending it to out without a trailing newline
+     * @return False if the message could not be formatted; the level then reads ERROR
+     */
+    bool format(const LogEntry& entry, ISink& sink, std::string& out);
+
+private:
+    enum class Op : uint8_t {
+        LITERAL, YEAR, MONTH, DAY, HOUR, MINUTE, SECOND, MILLIS, MICROS, NANOS,
+        LEVEL, THREAD, CONTEXT, SINK_NAME, MESSAGE,
+        STRFTIME,       // Other strftime flag of a custom TimestampFormatter, e.g. %b, in literals_
+        THREAD_TAG,     // "[name] " if the thread is named, built-in layout only
+        CONTEXT_TAG     // "[key=value ...] " if there is a context, built-in layout only
+    };
+
+    struct Step {
+        Op op;
+        uint32_t offset = 0;    // LITERAL text in literals_
+        uint32_t length = 0;
+    };
+
+    void add_literal(std::string_view text);
+    void add_timestamp(const TimestampFormatter& timestamp_formatter);
+    void update_time(uint64_t timestamp_ns);
+
+    std::vector<Step> steps_;
+    std::string literals_;
+    std::string message_;           // Reused buffer for the formatted message
+    int64_t cached_second_ = -1;
+    std::tm cached_tm_{};
+};
+
+class ConsoleSink : public ISink {
+public:
+    explicit ConsoleSink(bool use_colors = true, bool use_stderr_for_errors = true,
+                         TimestampFormatter::Format timestamp_format = TimestampFormatter::Format::WITH_MICROSECONDS,
+                         std::string&& name = "");
+    
+    explicit ConsoleSink(const std::string& custom_timestamp_format, bool use_colors = true, 
+                        bool use_stderr_for_errors = true, std::string&& name = "");
+
+    ~ConsoleSink() override;
+
+    /**
+     * @brief Render the entry into the pending batch for its output stream
+     * The batch is written out by flush(), which the logger calls after each batch of entries.
+     */
     void write(const LogEntry& entry) override;
     void flush() override;
 
+    /**
+     * @brief Replace the line layout, see PatternLayout
+     * Set it before the sink is added to a running logger.
+     */
+    void set_pattern(std::string_view pattern) { layout_ = PatternLayout(pattern); }
+
 private:
-    std::string format_log_entry(const LogEntry& entry);
-    std::string get_color_code(LogLevel level);
-    std::string get_reset_code();
-    
+    void format_log_entry(const LogEntry& entry, std::string& out);
+    static std::string_view get_color_code(LogLevel level) noexcept;
+    static void write_fd(int fd, std::string& batch) noexcept;
+
+    static constexpr std::string_view reset_code_ = "\033[0m";
+    static constexpr size_t max_batch_size_ = 64 * 1024; // Write out early beyond this
+
     bool use_colors_;
     bool use_stderr_for_errors_;
-    TimestampFormatter timestamp_formatter_;
+    PatternLayout layout_;
+    std::string stdout_batch_;
+    std::string stderr_batch_;
 };
 
 class FileSink : public ISink {
@@ -337,12 +1189,22 @@ public:
     void write(const LogEntry& entry) override;
     void flush() override;
 
+    /**
+     * @brief Replace the line layout, see PatternLayout
+     * Set it before the sink is added to a running logger.
+     */
+    void set_pattern(std::string_view pattern) { layout_ = PatternLayout(pattern); }
+
 protected:
-    std::string format_log_entry(const LogEntry& entry);
+    /**
+     * @brief Render the entry's line, without newline, into a buffer reused across entries
+     */
+    const std::string& format_log_entry(const LogEntry& entry);
     
     std::filesystem::path file_path_;
     std::ofstream file_stream_;
-    TimestampFormatter timestamp_formatter_;
+    PatternLayout layout_;
+    std::string format_buffer_;
 };
 
 class RotatingFileSink : public FileSink {
@@ -359,11 +1221,17 @@ public:
 private:
     void check_rotation();
     void rotate_files();
-    std::filesystem::path get_rotated_filename(size_t index);
+    void shift_rotated_files(const std::filesystem::path& staged);
+    void recover_staged_files();
+    std::filesystem::path get_rotated_filename(size_t index) const;
+    std::filesystem::path get_staged_filename(uint64_t seq) const;
     
     RotationConfig config_;
     std::filesystem::path base_path_;
     size_t current_file_size_;
+    uint64_t rotation_seq_ = 0;
+    std::unique_ptr<BackgroundCompressor> compressor_; // Only set when config_.compress_old is enabled
+    std::unique_ptr<BackgroundWorker> janitor_;         // Renames and removes rotated files off the writer thread
 };
 
 class DailyFileSink : public FileSink {
@@ -378,19 +1246,393 @@ public:
     void write(const LogEntry& entry) override;
 
 protected:
-    void check_rotation();
-    virtual std::string get_date_string() const;
+    void check_rotation(uint64_t timestamp_ns);
+    void rotate_to_new_day(uint64_t timestamp_ns);
+    virtual std::string get_date_string(uint64_t timestamp_ns) const;
+    virtual uint64_t get_next_midnight(uint64_t timestamp_ns) const;
     void rotate_daily_files();
     void rotate_files_for_date(const std::string& date);
 
-    std::filesystem::path get_daily_filename() const;
+    std::filesystem::path get_daily_filename(uint64_t timestamp_ns) const;
     std::filesystem::path get_dated_filename(const std::string& date) const;
     std::filesystem::path get_dated_indexed_filename(const std::string& date, size_t index) const;
 
+    static uint64_t now_ns() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
     RotationConfig config_;
     std::filesystem::path base_path_;
     std::string current_date_;
+    uint64_t next_rotation_ns_ = 0; // Local midnight ending current_date_, compared against entry timestamps
     size_t current_file_size_;
+    std::unique_ptr<BackgroundCompressor> compressor_; // Only set when config_.compress_old is enabled
+};
+
+/**
+ * @brief Append a string to out as the body of a JSON string literal (without quotes)
+ * Runs of characters that need no escaping are found 16 bytes at a time with SSE2 where available.
+ */
+void append_json_escaped(std::string& out, std::string_view str);
+
+/**
+ * @brief Append bytes to out as contiguous hex digits
+ * Converts 16 bytes at a time with SSE2 where available.
+ */
+void append_hex(std::string& out, const uint8_t* data, size_t size, bool uppercase = false);
+
+/**
+ * @brief Append a hexdump of bytes to out: one line per 16 bytes, each starting with a newline,
+ * with the offset, the bytes in hex and an ASCII column
+ */
+void append_hexdump(std::string& out, const uint8_t* data, size_t size);
+
+/**
+ * @brief Append an ARRAY payload to out using std::format range syntax
+ * `{}` gives `[1, 2, 3]`, `{::.2f}` applies `.2f` to each element and `{:n}` omits the brackets.
+ * @param spec The replacement field, including braces
+ */
+void append_array(std::string& out, const StringRef& payload, std::string_view spec);
+
+/**
+ * @brief Append a decimal to out using integer arithmetic only
+ * Like std::format, a negative value keeps its sign when it rounds to zero ("-0.00").
+ * @param precision Fractional digits to print, or -1 for all of them
+ */
+void append_decimal(std::string& out, Decimal value, int precision = -1);
+
+/**
+ * @brief Append a decimal to out for a replacement field such as `{:>12.2f}`
+ * @param spec The replacement field, including braces
+ */
+void append_decimal(std::string& out, Decimal value, std::string_view spec);
+
+/**
+ * @brief Sink writing one JSON object per line (JSON Lines)
+ *
+ * Each line holds the timestamp (nanoseconds since epoch), thread id, level, rendered message
+ * and the typed arguments as native JSON values:
+ * {"timestamp":1724686245123456789,"thread":1,"level":"INFO","message":"qty 100 px 1.5","args":[100,1.5]}
+ * A named thread adds "thread_name", a thread context adds a "context" object and named
+ * arguments go in a "fields" object.
+ * Lines are rendered into reused buffers, so steady-state logging does not allocate.
+ */
+class JsonLinesSink : public FileSink {
+public:
+    explicit JsonLinesSink(const std::filesystem::path& file_path, std::string&& name = "");
+
+    void write(const LogEntry& entry) override;
+
+protected:
+    void format_json_entry(const LogEntry& entry, std::string& out);
+    static void append_json_value(const LogArgument& arg, std::string& out);
+
+    std::string line_buffer_;
+    std::string message_buffer_;
+};
+
+/**
+ * @brief In-memory sink that keeps the most recent entries and writes them out on demand
+ *
+ * Entries are stored raw, formatting is deferred to dump(). Dynamic strings and bytes are copied into
+ * an internal arena since the logger's string queue is reused. The sink accepts all levels by
+ * default, so TRACE context is available around an incident even when other sinks filter it.
+ * A FATAL entry triggers a dump automatically. That dump runs inside write(), so the whole ring is
+ * formatted and written to disk on the logger's writer thread and every other sink waits for it.
+ * Wrap the recorder in an AsyncSink to take the dump off the writer thread.
+ */
+class FlightRecorderSink : public ISink {
+public:
+    /**
+     * @brief Construct a flight recorder
+     * @param dump_path File the recorded entries are appended to on dump
+     * @param capacity Number of entries kept (rounded up to a power of 2)
+     * @param string_capacity Bytes reserved for copies of dynamic string arguments
+     * @param name Optional name for the sink
+     */
+    explicit FlightRecorderSink(const std::filesystem::path& dump_path, size_t capacity = 8192,
+                                size_t string_capacity = 1024 * 1024, std::string&& name = "");
+
+    void write(const LogEntry& entry) override;
+    void flush() override {}
+
+    /**
+     * @brief Format the recorded entries to the dump file and clear the recorder
+     * Safe to call from any thread.
+     */
+    void dump();
+
+    /**
+     * @brief Number of entries currently recorded
+     */
+    size_t size() const;
+
+    const std::filesystem::path& dump_path() const noexcept { return dump_path_; }
+
+    /**
+     * @brief Replace the layout of dumped lines, see PatternLayout
+     * Set it before the sink is added to a running logger.
+     */
+    void set_pattern(std::string_view pattern) { layout_ = PatternLayout(pattern); }
+
+private:
+    bool copy_strings(LogEntry& entry);
+    void evict_strings_before(uint64_t arena_end);
+    void dump_locked();
+
+    std::filesystem::path dump_path_;
+    PatternLayout layout_;
+    mutable std::mutex mutex_;                      // Uncontended except while dumping
+    std::vector<LogEntry> entries_;
+    std::vector<uint64_t> arena_begin_;             // Arena position of each entry's first copied string
+    uint64_t mask_;
+    uint64_t head_ = 0;                             // Next entry to write
+    uint64_t tail_ = 0;                             // Oldest recorded entry
+    std::vector<char> arena_;
+    uint64_t arena_pos_ = 0;                        // Total bytes ever allocated from the arena
+    std::string line_buffer_;
+};
+
+/**
+ * @brief What AsyncSink does when its queue is full
+ */
+enum class AsyncOverflow : uint8_t {
+    DROP,   // Discard the new entry and count it in dropped()
+    BLOCK,  // Wait for the sink's thread to make room, stalling the logger's writer thread
+};
+
+/**
+ * @brief Decorator that runs a slow sink on its own thread
+ *
+ * The logger's writer thread only copies each entry, with its dynamic strings, into a bounded
+ * SPSC queue. A dedicated thread formats and writes it through the inner sink, so a slow
+ * destination (a socket, a remote service) no longer delays the other sinks. Entries below the
+ * inner sink's min_level() are dropped on the writer thread, before they are queued.
+ */
+template<typename Inner = ISink>
+class AsyncSink : public ISink {
+public:
+    /**
+     * @brief Wrap a sink
+     * @param inner Sink written to from the async thread; it must not also be added to the Logger
+     * @param capacity Queue size in entries (rounded up to a power of 2)
+     * @param overflow Action taken when the queue is full
+     * @param name Optional name for the sink
+     */
+    explicit AsyncSink(std::shared_ptr<Inner> inner, size_t capacity = 8192,
+                       AsyncOverflow overflow = AsyncOverflow::DROP, std::string&& name = "");
+    ~AsyncSink() override;
+
+    AsyncSink(const AsyncSink&) = delete;
+    AsyncSink& operator=(const AsyncSink&) = delete;
+
+    void write(const LogEntry& entry) override;
+    void flush() override {}    // the async thread flushes the inner sink after each batch
+
+    /**
+     * @brief Number of entries discarded because the queue was full
+     */
+    uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    Inner& inner() noexcept { return *inner_; }
+
+private:
+    struct Slot {
+        LogEntry entry;
+        std::string strings;    // Owns the entry's dynamic strings, capacity is reused
+    };
+
+    void run();
+
+    std::shared_ptr<Inner> inner_;
+    std::vector<Slot> slots_;
+    uint64_t mask_;
+    AsyncOverflow overflow_;
+    alignas(64) std::atomic<uint64_t> head_{0};     // Written by the logger's writer thread
+    alignas(64) std::atomic<uint64_t> tail_{0};     // Written by the async thread
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+#ifndef _WIN32
+/**
+ * @brief Control block at the start of a ShmRingSink shared-memory segment
+ *
+ * The ring follows SlickQueue's reserve/publish protocol over a byte ring: the single writer
+ * bumps reserved_cursor before copying a record and published_cursor after it. Readers keep
+ * their own cursor, and use reserved_cursor to detect records overwritten while reading.
+ */
+struct ShmRingHeader {
+    static constexpr uint64_t MAGIC = 0x474F4C4B43494C53ULL; // "SLICKLOG"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t capacity;                          // Size of the data area in bytes, power of 2
+    std::atomic<uint64_t> epoch;                // Bumped each time a writer initializes the ring
+    alignas(64) std::atomic<uint64_t> reserved_cursor;
+    alignas(64) std::atomic<uint64_t> published_cursor;
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ShmRingSink needs address-free 64-bit atomics");
+
+/**
+ * @brief Record header preceding each rendered message in the ring
+ * Records are 8-byte aligned and never straddle the end of the ring.
+ */
+struct ShmRecordHeader {
+    static constexpr uint32_t WRAP = UINT32_MAX; // Rest of the ring is padding, continue at offset 0
+
+    uint32_t size;      // Message bytes following the header
+    LogLevel level;
+    uint8_t reserved[3];
+    uint64_t timestamp; // nanoseconds since epoch
+};
+
+/**
+ * @brief Sink that publishes rendered messages into a POSIX shared-memory ring
+ *
+ * A separate process (see examples/slick_log_tail.cpp and ShmRingReader) consumes the ring
+ * and forwards it, taking file and network I/O out of the logging process. The segment
+ * outlives the writer, so a reader can drain it after the writer exits or crashes.
+ * Slow readers never block the writer; they detect that they were overrun instead.
+ */
+class ShmRingSink : public ISink {
+public:
+    /**
+     * @brief Create or reinitialize a shared-memory ring
+     * @param shm_name Segment name as passed to shm_open (a leading '/' is added if missing)
+     * @param capacity Ring size in bytes (rounded up to a power of 2, default 4MB)
+     * @param name Optional name for the sink
+     * @param unlink_on_close Remove the segment when the sink is destroyed
+     */
+    explicit ShmRingSink(std::string shm_name, size_t capacity = 4194304, std::string&& name = "", bool unlink_on_close = false);
+    ~ShmRingSink() override;
+
+    ShmRingSink(const ShmRingSink&) = delete;
+    ShmRingSink& operator=(const ShmRingSink&) = delete;
+
+    void write(const LogEntry& entry) override;
+    void flush() override {}
+
+    const std::string& shm_name() const noexcept { return shm_name_; }
+
+private:
+    void publish_record(LogLevel level, uint64_t timestamp, std::string_view message);
+
+    std::string shm_name_;
+    bool unlink_on_close_;
+    size_t mapped_size_ = 0;
+    ShmRingHeader* header_ = nullptr;
+    char* data_ = nullptr;
+    uint64_t mask_ = 0;
+    uint64_t cursor_ = 0;
+    std::string message_buffer_;
+};
+
+/**
+ * @brief Reads records published by a ShmRingSink, typically from another process
+ */
+class ShmRingReader {
+public:
+    struct Record {
+        LogLevel level;
+        uint64_t timestamp;
+        std::string message;    // Reused between reads
+    };
+
+    /**
+     * @brief Attach to an existing ring
+     * @param shm_name Segment name used by the ShmRingSink
+     * @param from_oldest Start from the oldest record that can still be located instead of new
+     *        records only. Records never straddle the end of the ring, so every lap starts on a
+     *        record boundary: once the ring has wrapped, reading starts at the beginning of the
+     *        current lap and older records left in the tail of the previous lap are skipped.
+     */
+    explicit ShmRingReader(std::string shm_name, bool from_oldest = false);
+    ~ShmRingReader();
+
+    ShmRingReader(const ShmRingReader&) = delete;
+    ShmRingReader& operator=(const ShmRingReader&) = delete;
+
+    /**
+     * @brief Read the next record
+     * @return False if no complete record is available
+     */
+    bool read(Record& record);
+
+    /**
+     * @brief Number of bytes skipped because the writer overran this reader
+     */
+    uint64_t lost_bytes() const noexcept { return lost_bytes_; }
+
+private:
+    void resync(uint64_t published);
+
+    std::string shm_name_;
+    size_t mapped_size_ = 0;
+    const ShmRingHeader* header_ = nullptr;
+    const char* data_ = nullptr;
+    uint64_t capacity_ = 0;
+    uint64_t cursor_ = 0;
+    uint64_t epoch_ = 0;
+    uint64_t lost_bytes_ = 0;
+};
+#endif
+
+/**
+ * @brief Named logging category, e.g. "fix.session", with its own level and default sinks
+ *
+ * Categories are created once through Logger::category() and stay valid for the lifetime
+ * of the logger, so handles can be cached in statics:
+ *
+ *   static auto& log = Logger::instance().category("fix.session");
+ *   LOG_CAT_DEBUG(log, "Heartbeat {}", seq);
+ *
+ * The level is resolved from the logger's category rules (see Logger::set_category_levels) and
+ * replaces the logger's global level, so "fix.session=TRACE" works while the logger is at INFO.
+ * A call filtered by the category costs a single relaxed load.
+ */
+class Category {
+public:
+    Category(Logger& logger, std::string name) : logger_(logger), name_(std::move(name)) {}
+
+    Category(const Category&) = delete;
+    Category& operator=(const Category&) = delete;
+
+    const std::string& name() const noexcept { return name_; }
+
+    LogLevel level() const noexcept { return level_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether a level passes this category's filter
+     */
+    bool should_log(LogLevel level) const noexcept { return level >= level_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Set the level directly, until the category rules change again
+     */
+    void set_level(LogLevel level) noexcept { level_.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Sinks this category logs to, 0 for all non-dedicated sinks
+     */
+    uint64_t sink_mask() const noexcept { return sink_mask_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Route this category to a set of sinks (see Logger::sink_mask())
+     */
+    void set_sink_mask(uint64_t mask) noexcept { sink_mask_.store(mask, std::memory_order_relaxed); }
+
+    template<typename FormatT, typename... Args>
+    void log(LogLevel level, FormatT&& format, Args&&... args);
+
+private:
+    Logger& logger_;
+    std::string name_;
+    std::atomic<LogLevel> level_{LogLevel::L_TRACE};
+    std::atomic<uint64_t> sink_mask_{0};
 };
 
 /**
@@ -399,17 +1641,57 @@ protected:
 struct LogConfig {
     std::vector<std::shared_ptr<ISink>> sinks;
     LogLevel min_level = LogLevel::L_TRACE;
+    std::string category_levels;    // Category rules, e.g. "fix.*=DEBUG,fix.session=TRACE" (see Logger::set_category_levels). Empty keeps the current rules
     size_t log_queue_size = 65536;
     size_t string_buffer_size = 4194304; // 4MB
+    bool huge_pages = false;        // Best effort: back the queues' data arrays with 2MB transparent huge pages (Linux), see README
+    bool prefault_queues = false;   // Touch every queue page in init, before logging starts
+    bool lock_queues = false;       // mlock both queues; needs CAP_IPC_LOCK or a large enough RLIMIT_MEMLOCK
+    int numa_node = -1;             // Place both queues and the writer thread on this NUMA node (Linux), -1 for no placement
+    bool version_banner = true;     // Log "SlickLogger v<version>" when the logger starts
 };
 
+class LogBatch;
+
 /**
- * @brief Singleton Logger class
+ * @brief Logger with its own queues and writer thread
+ *
+ * instance() is the default logger used by the LOG_* macros. Components that need their own
+ * queue sizes or an isolated writer thread can create additional loggers; sinks and
+ * categories belong to the logger they were added to or created by.
  */
 class Logger {
 public:
+    Logger() = default;
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    Logger(Logger&&) = delete;
+    Logger& operator=(Logger&&) = delete;
+
+    /**
+     * @brief Default global logger
+     */
     static Logger& instance();
 
+    /**
+     * @brief Name the calling thread in log output, e.g. "md-feed-3"
+     * Names are process-wide and resolved by the writer thread, so log calls only store
+     * the thread's dense id.
+     */
+    static void set_thread_name(std::string_view name) {
+        ThreadRegistry::instance().set_name(current_thread_id(), name);
+    }
+
+    /**
+     * @brief Name of a thread by its id, see current_thread_id()
+     * @return The name, or an empty view if the thread has none
+     */
+    static std::string_view thread_name(uint32_t thread_id) noexcept {
+        return ThreadRegistry::instance().name(thread_id);
+    }
+
     /**
      * @brief Initialize the logger with a log file path
      * @param log_file Path to the log file
@@ -437,8 +1719,26 @@ public:
      */
     void add_sink(std::shared_ptr<ISink> sink);
 
+    /**
+     * @brief Detach a sink, also while the logger is running
+     * Once this returns, the writer thread no longer writes to the sink (unless called from
+     * the writer thread itself, e.g. from inside a sink).
+     * @param sink Sink to remove
+     * @return False if the sink was not attached to this logger
+     */
+    bool remove_sink(const std::shared_ptr<ISink>& sink);
+
+    /**
+     * @brief Detach a sink by name, also while the logger is running
+     * @param name Name of the sink
+     * @return False if no sink has this name
+     */
+    bool remove_sink(std::string_view name);
+
     /** 
-     * @brief Clear all existing sinks
+     * @brief Detach all sinks, also while the logger is running
+     * Like remove_sink(), waits until the writer thread no longer writes to them. Their sink
+     * bits stay taken until reset(), so queued targeted entries never reach a new sink.
      */
     void clear_sinks();
     
@@ -544,7 +1844,32 @@ public:
     void add_daily_file_sink(const std::filesystem::path& path, const RotationConfig& config, const std::string& custom_timestamp_format, std::string&& name = "");
 
     /**
-     * @brief Get the sink of givent type
+     * @brief Add a JSON Lines sink
+     * @param path Path to the log file
+     * @param name Optional name for the sink
+     */
+    void add_json_lines_sink(const std::filesystem::path& path, std::string&& name = "");
+
+    /**
+     * @brief Add a flight recorder sink that keeps recent entries in memory
+     * @param dump_path File the recorded entries are appended to on FATAL or dump()
+     * @param capacity Number of entries kept
+     * @param name Optional name for the sink
+     */
+    void add_flight_recorder_sink(const std::filesystem::path& dump_path, size_t capacity = 8192, std::string&& name = "");
+
+#ifndef _WIN32
+    /**
+     * @brief Add a shared-memory ring sink for an out-of-process reader
+     * @param shm_name Shared memory segment name
+     * @param capacity Ring size in bytes
+     * @param name Optional name for the sink
+     */
+    void add_shm_ring_sink(const std::string& shm_name, size_t capacity = 4194304, std::string&& name = "");
+#endif
+
+    /**
+     * @brief Get the sink of givent type
      * @return The shared_ptr of the given sink type. It could be null if the sink of give type doesn't exist
      */
     template<typename SinkT>
@@ -561,7 +1886,7 @@ public:
      * @return Current LogLevel
      */
     LogLevel get_level() const noexcept {
-        return log_level_.load(std::memory_order_relaxed);
+        return static_cast<LogLevel>(gate_.word.load(std::memory_order_relaxed) & GATE_LEVEL_MASK);
     }
 
     /**
@@ -569,9 +1894,38 @@ public:
      * @param level Minimum LogLevel to set
      */
     void set_level(LogLevel level) {
-        log_level_.store(level, std::memory_order_release);
+        uint32_t gate = gate_.word.load(std::memory_order_relaxed);
+        while (!gate_.word.compare_exchange_weak(gate, (gate & GATE_CLOSED) | static_cast<uint32_t>(level), std::memory_order_release)) {
+        }
     }
 
+    /**
+     * @brief Log "SlickLogger v<version>" as the first entry each time the logger starts
+     * @param enabled Whether to log the banner (default true)
+     */
+    void set_version_banner(bool enabled) noexcept { version_banner_ = enabled; }
+
+    /**
+     * @brief Get or create a category
+     * The returned reference stays valid for the lifetime of the logger.
+     * @param name Dot separated category name, e.g. "fix.session"
+     */
+    Category& category(std::string_view name);
+
+    /**
+     * @brief Set category levels from rules
+     *
+     * Rules are separated by ',' ';' or newlines, each is `pattern=LEVEL`:
+     * - `fix.session=TRACE` applies to that category only
+     * - `fix.*=DEBUG` applies to `fix` and every category below it
+     * - `*=WARN` applies to all categories
+     * The most specific rule wins. Categories without a matching rule accept all levels,
+     * leaving filtering to the global level. Replaces previous rules.
+     * @param rules Rule list
+     * @throws std::runtime_error on a malformed rule or unknown level
+     */
+    void set_category_levels(std::string_view rules);
+
     /**
      * @brief Log a message with a specific log level and format
      * @param level LogLevel of the message
@@ -591,30 +1945,84 @@ public:
     template<typename FormatT, typename... Args>
     void log_to_sink(int sink_index, LogLevel level, FormatT&& format, Args&&... args);
 
+    /**
+     * @brief Log a message to a set of sinks with a single entry
+     * @param sink_mask Target sinks, one bit per sink (see ISink::mask() and sink_mask()). 0 logs to all non-dedicated sinks
+     * @param level LogLevel of the message
+     * @param format Format string (printf-style)
+     * @param args Arguments for the format string
+     */
+    template<typename FormatT, typename... Args>
+    void log_to_sinks(uint64_t sink_mask, LogLevel level, FormatT&& format, Args&&... args);
+
+    /**
+     * @brief Reserve n contiguous queue entries for a burst of related lines
+     * The returned scope fills them in order and publishes them together when it ends, so
+     * the lines stay contiguous and the queue is contended once rather than per line.
+     * Slots left unused are skipped by the writer thread. While the logger is stopped the
+     * batch is inactive and drops its lines, like log().
+     * @param n Number of entries, at most the queue size
+     * @throws std::runtime_error if n exceeds the queue size
+     */
+    LogBatch batch(uint32_t n);
+
+    /**
+     * @brief Build a routing mask from sink names
+     * @param names Names of the sinks; unknown names are ignored
+     * @return Mask to pass to log_to_sinks
+     */
+    uint64_t sink_mask(std::initializer_list<std::string_view> names) const noexcept;
+
     /**
      * @brief Shutdown the logger and flush all pending log entries
+     * The queues are kept, so a following init() with the same sizes reuses them.
      * @param clear_sinks Clear sink list
      */
     void shutdown(bool clear_sinks = true);
 
     /**
-     * @brief Reset the logger to uninitialized state
+     * @brief Reset the logger to uninitialized state, releasing the queues
      * Note: This is primarily for testing purposes. Use with caution.
      */
     void reset();
 
 private:
-    Logger() = default;
-    ~Logger();
+    friend class ISink;
+    friend class LogBatch;
+    friend class Category;
 
-    Logger(const Logger&) = delete;
-    Logger& operator=(const Logger&) = delete;
-    Logger(Logger&&) = delete;
-    Logger& operator=(Logger&&) = delete;
+    // Send path of Category::log, which has already applied its own level in place of the
+    // global one: only checks that the logger is running
+    template<typename FormatT, typename... Args>
+    void log_category(uint64_t sink_mask, LogLevel level, FormatT&& format, Args&&... args);
+
+    template<typename FormatT, typename... Args>
+    void fill_entry(LogEntry& entry, uint64_t sink_mask, LogLevel level, FormatT&& format, Args&&... args);
 
-    void start();
+    void create_queues(size_t log_queue_size, size_t string_buffer_size);
+    bool start(int numa_node = -1);
     void writer_thread_func();
     void write_log_entry(const LogEntry* entry_ptr, uint32_t count);
+
+    // Sinks and their routing tables, immutable once published. Updates copy the table and
+    // swap the pointer, so the writer thread reads it without a lock (RCU style).
+    static constexpr size_t LEVEL_COUNT = static_cast<size_t>(LogLevel::L_OFF) + 1;
+    struct SinkTable {
+        std::vector<std::shared_ptr<ISink>> sinks;  // Indexed by sink bit, removed sinks leave a null slot
+        std::unordered_map<std::string_view, int> name_index;
+        std::array<uint64_t, LEVEL_COUNT> broadcast_routes{};   // Non-dedicated sinks accepting each level
+        std::array<uint64_t, LEVEL_COUNT> level_routes{};       // All sinks accepting each level, masks targeted entries
+        size_t sink_count = 0;
+
+        void rebuild_routes() noexcept;
+    };
+
+    template<typename F>
+    uint64_t update_sinks(F&& update);
+    void wait_for_writer(uint64_t epoch) const;
+    void refresh_routes();
+    void retire_sink_table(SinkTable* table, uint64_t epoch);
+    void reclaim_sink_tables();
     
     // Helper function to round up to next power of 2
     static size_t round_up_to_power_of_2(size_t value) noexcept;
@@ -626,13 +2034,94 @@ private:
 
     std::unique_ptr<slick::SlickQueue<LogEntry>> log_queue_;
     std::unique_ptr<slick::SlickQueue<char>> string_queue_;
-    std::vector<std::shared_ptr<ISink>> sinks_;
     std::filesystem::path log_file_;
     std::thread writer_thread_;
     std::atomic<bool> running_{false};
+    std::atomic<bool> writer_ready_{false};     // Set by the writer thread once it runs, see start()
+    bool version_banner_ = true;
     uint64_t read_index_{0};
-    std::atomic<LogLevel> log_level_{LogLevel::L_TRACE};
-    std::unordered_map<std::string_view, int> sinkname_index_map_;
+
+    // Fast-path gate: the minimum level in the low byte, plus GATE_CLOSED while the logger is
+    // not running. A call passes if its level >= gate, so filtered and stopped calls both cost
+    // one load and one compare. Padded to a full cache line, so stores to the writer-side
+    // state below (writer_epoch_ is stored twice per batch) never invalidate it.
+    static constexpr uint32_t GATE_LEVEL_MASK = 0xFF;
+    static constexpr uint32_t GATE_CLOSED = 0x100;
+    struct alignas(64) GateLine {
+        std::atomic<uint32_t> word{GATE_CLOSED | static_cast<uint32_t>(LogLevel::L_TRACE)};
+    };
+    static_assert(sizeof(GateLine) == 64 && alignof(GateLine) == 64, "The gate must own its cache line");
+    GateLine gate_;
+
+    // Epoch-based reclamation of replaced sink tables. The writer thread announces the epoch
+    // it entered a batch in, a retired table is freed once the writer is idle or has entered
+    // an epoch after the table was replaced.
+    static constexpr uint64_t IDLE_EPOCH = UINT64_MAX;
+    std::atomic<SinkTable*> sink_table_{new SinkTable()};
+    std::atomic<uint64_t> global_epoch_{0};
+    std::atomic<uint64_t> writer_epoch_{IDLE_EPOCH};
+    std::atomic<bool> has_retired_{false};
+    mutable std::mutex sink_mutex_;        // Serializes sink table updates
+    std::vector<std::pair<SinkTable*, uint64_t>> retired_tables_;
+
+    LogLevel resolve_category_level(std::string_view name) const;
+
+    std::mutex category_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Category>> categories_;
+    std::unordered_map<std::string, LogLevel> category_rules_;    // pattern -> level
+};
+
+/**
+ * @brief Entries reserved with Logger::batch(), published together when the scope ends
+ *
+ *     auto batch = logger.batch(levels.size());
+ *     for (const auto& level : levels) {
+ *         batch.log(LogLevel::L_INFO, "{} {} @ {}", level.side, level.qty, level.px);
+ *     }
+ *
+ * Lines beyond the reserved count are logged individually after the batch's entries.
+ * A batch belongs to the thread that created it. The logger must not be shut down
+ * while a batch is open.
+ */
+class LogBatch {
+public:
+    LogBatch(LogBatch&& other) noexcept
+        : logger_(std::exchange(other.logger_, nullptr)), start_(other.start_)
+        , capacity_(other.capacity_), used_(other.used_) {
+    }
+    LogBatch(const LogBatch&) = delete;
+    LogBatch& operator=(const LogBatch&) = delete;
+    LogBatch& operator=(LogBatch&&) = delete;
+
+    ~LogBatch() {
+        publish();
+    }
+
+    /**
+     * @brief Log a line into the next reserved entry, see Logger::log()
+     */
+    template<typename FormatT, typename... Args>
+    void log(LogLevel level, FormatT&& format, Args&&... args);
+
+    /**
+     * @brief Publish the filled entries now and end the batch
+     */
+    void publish() noexcept;
+
+    uint32_t size() const noexcept { return used_; }
+    uint32_t capacity() const noexcept { return capacity_; }
+
+private:
+    friend class Logger;
+
+    LogBatch(Logger* logger, uint64_t start, uint32_t capacity) noexcept
+        : logger_(logger), start_(start), capacity_(capacity) {
+    }
+
+    Logger* logger_;        // Null once published, or if the logger was stopped
+    uint64_t start_;
+    uint32_t capacity_;
+    uint32_t used_ = 0;
 };
 
 
@@ -640,9 +2129,34 @@ private:
 // ------------------------------ Implementation (header-only library) ------------------------------
 
 
+inline void ISink::set_min_level(LogLevel level) {
+    min_level_.store(level, std::memory_order_relaxed);
+    if (logger_) {
+        logger_->refresh_routes();
+    }
+}
+
+inline void ISink::set_dedicated(bool dedicated) {
+    dedicated_ = dedicated;
+    if (logger_) {
+        logger_->refresh_routes();
+    }
+}
+
+template<typename FormatT, typename... Args>
+inline void Category::log(LogLevel level, FormatT&& format, Args&&... args) {
+    if (level < level_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    logger_.log_category(sink_mask_.load(std::memory_order_relaxed), level,
+        std::forward<FormatT>(format), std::forward<Args>(args)...);
+}
+
 template<typename FormatT, typename... Args>
 inline void ISink::log(LogLevel level, FormatT&& format, Args&&... args) {
-    Logger::instance().log_to_sink(index_, level, std::forward<FormatT>(format), std::forward<Args>(args)...);
+    // Sinks that were not added to a logger log through the default one
+    Logger& logger = logger_ ? *logger_ : Logger::instance();
+    logger.log_to_sink(index_, level, std::forward<FormatT>(format), std::forward<Args>(args)...);
 }
 
 template<typename FormatT, typename... Args>
@@ -675,172 +2189,520 @@ inline void ISink::log_fatal(FormatT&& format, Args&&... args) {
     log(LogLevel::L_FATAL, std::forward<FormatT>(format), std::forward<Args>(args)...);
 }
 
+inline PatternLayout::PatternLayout(std::string_view pattern) {
+    size_t literal_start = 0;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        if (pattern[i] != '%') {
+            continue;
+        }
+        add_literal(pattern.substr(literal_start, i - literal_start));
+        if (i + 1 >= pattern.size()) {
+            throw std::runtime_error("Pattern ends with %: " + std::string(pattern));
+        }
+        char flag = pattern[++i];
+        literal_start = i + 1;
+        switch (flag) {
+            case 'Y': steps_.push_back({Op::YEAR}); break;
+            case 'm': steps_.push_back({Op::MONTH}); break;
+            case 'd': steps_.push_back({Op::DAY}); break;
+            case 'H': steps_.push_back({Op::HOUR}); break;
+            case 'M': steps_.push_back({Op::MINUTE}); break;
+            case 'S': steps_.push_back({Op::SECOND}); break;
+            case 'e': steps_.push_back({Op::MILLIS}); break;
+            case 'f': steps_.push_back({Op::MICROS}); break;
+            case 'N': steps_.push_back({Op::NANOS}); break;
+            case 'l': steps_.push_back({Op::LEVEL}); break;
+            case 't': steps_.push_back({Op::THREAD}); break;
+            case 'X': steps_.push_back({Op::CONTEXT}); break;
+            case 'n': steps_.push_back({Op::SINK_NAME}); break;
+            case 'v': steps_.push_back({Op::MESSAGE}); break;
+            case '%': add_literal("%"); break;
+            case 'F':
+                steps_.push_back({Op::YEAR});
+                add_literal("-");
+                steps_.push_back({Op::MONTH});
+                add_literal("-");
+                steps_.push_back({Op::DAY});
+                break;
+            case 'T':
+                steps_.push_back({Op::HOUR});
+                add_literal(":");
+                steps_.push_back({Op::MINUTE});
+                add_literal(":");
+                steps_.push_back({Op::SECOND});
+                break;
+            default:
+                throw std::runtime_error("Unknown pattern flag %" + std::string(1, flag) + " in: " + std::string(pattern));
+        }
+    }
+    add_literal(pattern.substr(literal_start));
+}
+
+inline PatternLayout::PatternLayout(TimestampFormatter timestamp_formatter) {
+    add_timestamp(timestamp_formatter);
+    add_literal(" [");
+    steps_.push_back({Op::LEVEL});
+    add_literal("] ");
+    steps_.push_back({Op::THREAD_TAG});
+    steps_.push_back({Op::CONTEXT_TAG});
+    steps_.push_back({Op::MESSAGE});
+}
+
+inline void PatternLayout::add_timestamp(const TimestampFormatter& timestamp_formatter) {
+    // Same output as TimestampFormatter::format_timestamp, compiled into the cached date ops
+    auto add_date = [this]() {
+        steps_.push_back({Op::YEAR});
+        add_literal("-");
+        steps_.push_back({Op::MONTH});
+        add_literal("-");
+        steps_.push_back({Op::DAY});
+    };
+    auto add_time = [this]() {
+        steps_.push_back({Op::HOUR});
+        add_literal(":");
+        steps_.push_back({Op::MINUTE});
+        add_literal(":");
+        steps_.push_back({Op::SECOND});
+    };
+
+    std::string_view custom = timestamp_formatter.custom_format();
+    switch (timestamp_formatter.format()) {
+        case TimestampFormatter::Format::CUSTOM:
+            if (!custom.empty()) {
+                break;
+            }
+            [[fallthrough]];
+        case TimestampFormatter::Format::DEFAULT:
+            add_date();
+            add_literal(" ");
+            add_time();
+            return;
+        case TimestampFormatter::Format::WITH_MICROSECONDS:
+            add_date();
+            add_literal(" ");
+            add_time();
+            add_literal(".");
+            steps_.push_back({Op::MICROS});
+            return;
+        case TimestampFormatter::Format::WITH_MILLISECONDS:
+            add_date();
+            add_literal(" ");
+            add_time();
+            add_literal(".");
+            steps_.push_back({Op::MILLIS});
+            return;
+        case TimestampFormatter::Format::ISO8601:
+            add_date();
+            add_literal("T");
+            add_time();
+            add_literal(".");
+            steps_.push_back({Op::MICROS});
+            add_literal("Z");
+            return;
+        case TimestampFormatter::Format::TIME_ONLY:
+            add_time();
+            add_literal(".");
+            steps_.push_back({Op::MICROS});
+            return;
+    }
+
+    // Custom strftime format, where %f is microseconds
+    size_t literal_start = 0;
+    for (size_t i = 0; i + 1 < custom.size(); ++i) {
+        if (custom[i] != '%') {
+            continue;
+        }
+        add_literal(custom.substr(literal_start, i - literal_start));
+        char flag = custom[++i];
+        literal_start = i + 1;
+        switch (flag) {
+            case 'Y': steps_.push_back({Op::YEAR}); break;
+            case 'm': steps_.push_back({Op::MONTH}); break;
+            case 'd': steps_.push_back({Op::DAY}); break;
+            case 'H': steps_.push_back({Op::HOUR}); break;
+            case 'M': steps_.push_back({Op::MINUTE}); break;
+            case 'S': steps_.push_back({Op::SECOND}); break;
+            case 'f': steps_.push_back({Op::MICROS}); break;
+            case 'F': add_date(); break;
+            case 'T': add_time(); break;
+            case '%': add_literal("%"); break;
+            default:
+                // Rendered by strftime from the cached broken-down time
+                steps_.push_back({Op::STRFTIME, static_cast<uint32_t>(literals_.size()), 2});
+                literals_ += '%';
+                literals_ += flag;
+                break;
+        }
+    }
+    add_literal(custom.substr(std::min(literal_start, custom.size())));
+}
+
+inline void PatternLayout::add_literal(std::string_view text) {
+    if (text.empty()) {
+        return;
+    }
+    // Merge adjacent literals, e.g. from %T followed by text
+    if (!steps_.empty() && steps_.back().op == Op::LITERAL && steps_.back().offset + steps_.back().length == literals_.size()) {
+        steps_.back().length += static_cast<uint32_t>(text.size());
+    } else {
+        steps_.push_back({Op::LITERAL, static_cast<uint32_t>(literals_.size()), static_cast<uint32_t>(text.size())});
+    }
+    literals_ += text;
+}
+
+inline void PatternLayout::update_time(uint64_t timestamp_ns) {
+    int64_t second = static_cast<int64_t>(timestamp_ns / 1000000000);
+    if (second == cached_second_) [[likely]] {
+        return;
+    }
+    time_t time_val = static_cast<time_t>(second);
+    std::tm* tm_ptr = std::localtime(&time_val);
+    cached_tm_ = tm_ptr ? *tm_ptr : std::tm{};
+    cached_second_ = second;
+}
+
+inline bool PatternLayout::format(const LogEntry& entry, ISink& sink, std::string& out) {
+    // The message goes first so a formatting error can be reflected in the level
+    message_.clear();
+    bool good = sink.format_log_message(entry, message_);
+
+    auto append_digits = [&out](uint64_t value, int width) {
+        char digits[20];
+        for (int i = width - 1; i >= 0; --i) {
+            digits[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        out.append(digits, width);
+    };
+    const uint64_t subsecond = entry.timestamp % 1000000000;
+
+    for (const Step& step : steps_) {
+        switch (step.op) {
+            case Op::LITERAL:
+                out.append(literals_, step.offset, step.length);
+                break;
+            case Op::YEAR:
+                update_time(entry.timestamp);
+                append_digits(static_cast<uint64_t>(cached_tm_.tm_year + 1900), 4);
+                break;
+            case Op::MONTH:
+                update_time(entry.timestamp);
+                append_digits(static_cast<uint64_t>(cached_tm_.tm_mon + 1), 2);
+                break;
+            case Op::DAY:
+                update_time(entry.timestamp);
+                append_digits(static_cast<uint64_t>(cached_tm_.tm_mday), 2);
+                break;
+            case Op::HOUR:
+                update_time(entry.timestamp);
+                append_digits(static_cast<uint64_t>(cached_tm_.tm_hour), 2);
+                break;
+            case Op::MINUTE:
+                update_time(entry.timestamp);
+                append_digits(static_cast<uint64_t>(cached_tm_.tm_min), 2);
+                break;
+            case Op::SECOND:
+                update_time(entry.timestamp);
+                append_digits(static_cast<uint64_t>(cached_tm_.tm_sec), 2);
+                break;
+            case Op::MILLIS:
+                append_digits(subsecond / 1000000, 3);
+                break;
+            case Op::MICROS:
+                append_digits(subsecond / 1000, 6);
+                break;
+            case Op::NANOS:
+                append_digits(subsecond, 9);
+                break;
+            case Op::LEVEL:
+                out += good ? to_string(entry.level) : "ERROR";
+                break;
+            case Op::THREAD: {
+                std::string_view name = ThreadRegistry::instance().name(entry.thread_id);
+                if (!name.empty()) {
+                    out += name;
+                } else {
+                    std::format_to(std::back_inserter(out), "{}", entry.thread_id);
+                }
+                break;
+            }
+            case Op::CONTEXT:
+                if (auto context = ContextRegistry::instance().find(entry.context_id)) {
+                    out += context->text;
+                }
+                break;
+            case Op::SINK_NAME:
+                out += sink.name();
+                break;
+            case Op::MESSAGE:
+                out += message_;
+                break;
+            case Op::STRFTIME: {
+                update_time(entry.timestamp);
+                char spec[3] = {literals_[step.offset], literals_[step.offset + 1], '\0'};
+                char buffer[64];
+                out.append(buffer, std::strftime(buffer, sizeof(buffer), spec, &cached_tm_));
+                break;
+            }
+            case Op::THREAD_TAG:
+                ISink::append_thread(entry, out);
+                break;
+            case Op::CONTEXT_TAG:
+                ISink::append_context(entry, out);
+                break;
+        }
+    }
+    return good;
+}
+
+inline void ISink::append_thread(const LogEntry& entry, std::string& out) {
+    std::string_view name = ThreadRegistry::instance().name(entry.thread_id);
+    if (!name.empty()) {
+        out += '[';
+        out += name;
+        out += "] ";
+    }
+}
+
+inline void ISink::append_context(const LogEntry& entry, std::string& out) {
+    if (entry.context_id == 0) [[likely]] {
+        return;
+    }
+    if (auto context = ContextRegistry::instance().find(entry.context_id)) {
+        out += '[';
+        out += context->text;
+        out += "] ";
+    }
+}
+
 inline std::pair<std::string, bool> ISink::format_log_message(const LogEntry& entry) {
+    std::string result;
+    bool good = format_log_message(entry, result);
+    return std::make_pair(std::move(result), good);
+}
+
+inline void ISink::format_argument(const LogArgument& arg, std::string_view format_spec, std::string& out) {
+    auto it = std::back_inserter(out);
+    switch (arg.type) {
+        case ArgType::BOOL:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.b));
+            break;
+        case ArgType::CHAR:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.c));
+            break;
+        case ArgType::U_CHAR:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.uc));
+            break;
+        // case ArgType::WCHAR:
+        //     std::vformat_to(it, format_spec, std::make_format_args(arg.value.wc));
+        //     break;
+        case ArgType::INT8_T:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.i8));
+            break;
+        case ArgType::UINT8_T:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.u8));
+            break;
+        case ArgType::INT16_T:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.i16));
+            break;
+        case ArgType::UINT16_T:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.u16));
+            break;
+        case ArgType::INT32_T:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.i32));
+            break;
+        case ArgType::UINT32_T:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.u32));
+            break;
+        case ArgType::INT64_T:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.i64));
+            break;
+        case ArgType::UINT64_T:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.u64));
+            break;
+        case ArgType::FLOAT:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.f));
+            break;
+        case ArgType::DOUBLE:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.d));
+            break;
+        case ArgType::PTR:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.ptr));
+            break;
+        case ArgType::STRING_LITERAL:
+            std::vformat_to(it, format_spec, std::make_format_args(arg.value.literal_ptr));
+            break;
+        case ArgType::STRING_DYNAMIC:
+        case ArgType::STRING_PERSISTENT: {
+            auto sv = std::string_view(arg.value.dynamic_str.ptr, arg.value.dynamic_str.length);
+            std::vformat_to(it, format_spec, std::make_format_args(sv));
+            if (arg.value.dynamic_str.truncated) {
+                out += "...";
+            }
+            break;
+        }
+        case ArgType::ARRAY:
+            append_array(out, arg.value.dynamic_str, format_spec);
+            break;
+        case ArgType::DECIMAL:
+            append_decimal(out, arg.value.decimal, format_spec);
+            break;
+        case ArgType::BYTES: {
+            auto data = reinterpret_cast<const uint8_t*>(arg.value.dynamic_str.ptr);
+            std::string_view spec = format_spec.substr(1, format_spec.size() - 2);
+            if (spec == ":dump") {
+                append_hexdump(out, data, arg.value.dynamic_str.length);
+                if (arg.value.dynamic_str.truncated) {
+                    out += "\n...";
+                }
+            } else if (spec.empty() || spec == ":x" || spec == ":X") {
+                append_hex(out, data, arg.value.dynamic_str.length, spec == ":X");
+                if (arg.value.dynamic_str.truncated) {
+                    out += "...";
+                }
+            } else {
+                throw std::format_error("invalid format spec for bytes, expected {}, {:x}, {:X} or {:dump}");
+            }
+            break;
+        }
+        default:
+            out += "<UNKNOWN>";
+            break;
+    }
+}
+
+inline bool ISink::format_log_message(const LogEntry& entry, std::string& out) {
     if (entry.arg_count == 0) {
-        return std::make_pair(entry.format_ptr, true);
+        out += entry.format_ptr;
+        return true;
     }
 
     // Since std::make_format_args doesn't work with custom types in MSVC,
     // we'll use a manual implementation that preserves std::format functionality
     // by manually parsing format specifiers and applying them to each argument
+    const size_t start_size = out.size();
     try {
-        std::string format_str = entry.format_ptr;
-        std::string result;
-        result.reserve(format_str.length() + 256); // Reserve some space for formatting
+        std::string_view format_str = entry.format_ptr;
 
         size_t pos = 0;
         uint8_t arg_index = 0;
 
         while (pos < format_str.length()) {
             size_t brace_start = format_str.find('{', pos);
-            if (brace_start == std::string::npos) {
+            if (brace_start == std::string_view::npos) {
                 // No more format specifiers, copy rest of string
-                result += format_str.substr(pos);
+                out += format_str.substr(pos);
                 break;
             }
 
             // Copy everything before the brace
-            result += format_str.substr(pos, brace_start - pos);
+            out += format_str.substr(pos, brace_start - pos);
 
             // Find the closing brace
             size_t brace_end = format_str.find('}', brace_start);
-            if (brace_end == std::string::npos) {
+            if (brace_end == std::string_view::npos) {
                 // Malformed format string
-                result += format_str.substr(brace_start);
+                out += format_str.substr(brace_start);
                 break;
             }
 
             if (arg_index >= entry.arg_count) {
                 // Not enough arguments
-                result += "<MISSING_ARG>";
+                out += "<MISSING_ARG>";
                 pos = brace_end + 1;
                 continue;
             }
 
             // Extract format spec (everything between { and })
-            std::string format_spec = format_str.substr(brace_start, brace_end - brace_start + 1);
+            std::string_view format_spec = format_str.substr(brace_start, brace_end - brace_start + 1);
 
-            // Format the argument using std::format with the specific format spec
-            const auto& arg = entry.args[arg_index];
-            std::string formatted_arg;
-
-            switch (arg.type) {
-                case ArgType::BOOL:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.b));
-                    break;
-                case ArgType::CHAR:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.c));
-                    break;
-                case ArgType::U_CHAR:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.uc));
-                    break;
-                // case ArgType::WCHAR:
-                //     formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.wc));
-                //     break;
-                case ArgType::INT8_T:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.i8));
-                    break;
-                case ArgType::UINT8_T:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.u8));
-                    break;
-                case ArgType::INT16_T:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.i16));
-                    break;
-                case ArgType::UINT16_T:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.u16));
-                    break;
-                case ArgType::INT32_T:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.i32));
-                    break;
-                case ArgType::UINT32_T:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.u32));
-                    break;
-                case ArgType::INT64_T:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.i64));
-                    break;
-                case ArgType::UINT64_T:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.u64));
-                    break;
-                case ArgType::FLOAT:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.f));
-                    break;
-                case ArgType::DOUBLE:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.d));
-                    break;
-                case ArgType::PTR:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.ptr));
-                    break;
-                case ArgType::STRING_LITERAL:
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(arg.value.literal_ptr));
-                    break;
-                case ArgType::STRING_DYNAMIC: {
-                    auto sv = std::string_view(arg.value.dynamic_str.ptr, arg.value.dynamic_str.length);
-                    formatted_arg = std::vformat(format_spec, std::make_format_args(sv));
-                    break;
-                }
-                default:
-                    formatted_arg = "<UNKNOWN>";
-                    break;
+            // Named argument: key=, then its value in the next slot
+            if (entry.args[arg_index].type == ArgType::KEY) {
+                out += entry.args[arg_index].value.literal_ptr;
+                out += '=';
+                ++arg_index;
             }
 
-            result += formatted_arg;
+            // Format the argument using std::format with the specific format spec
+            format_argument(entry.args[arg_index], format_spec, out);
+
             pos = brace_end + 1;
             arg_index++;
         }
 
-        return std::make_pair(result, true);
+        // Named arguments without a placeholder follow the message
+        for (; arg_index + 1 < entry.arg_count; ++arg_index) {
+            if (entry.args[arg_index].type == ArgType::KEY) {
+                out += ' ';
+                out += entry.args[arg_index].value.literal_ptr;
+                out += '=';
+                ++arg_index;
+                format_argument(entry.args[arg_index], "{}", out);
+            }
+        }
+
+        return true;
     } catch (const std::format_error& e) {
-        // Return error message if formatting fails
-        return std::make_pair(std::string("[FORMAT_ERROR: ") + e.what() +"]", false);
+        // Replace partial output with error message if formatting fails
+        out.resize(start_size);
+        out += "[FORMAT_ERROR: ";
+        out += e.what();
+        out += "]";
+        return false;
     } catch (...) {
-        return std::make_pair("[FORMAT_ERROR: Unknown format error]", false);
+        out.resize(start_size);
+        out += "[FORMAT_ERROR: Unknown format error]";
+        return false;
     }
 }
 
 inline ConsoleSink::ConsoleSink(bool use_colors, bool use_stderr_for_errors,
                                 TimestampFormatter::Format timestamp_format, std::string&& name)
     : ISink(std::move(name)), use_colors_(use_colors), use_stderr_for_errors_(use_stderr_for_errors)
-    , timestamp_formatter_(timestamp_format) {
+    , layout_(TimestampFormatter(timestamp_format)) {
 }
 
 inline ConsoleSink::ConsoleSink(const std::string& custom_timestamp_format, bool use_colors, 
                                 bool use_stderr_for_errors, std::string&& name)
     : ISink(std::move(name)), use_colors_(use_colors), use_stderr_for_errors_(use_stderr_for_errors)
-    , timestamp_formatter_(custom_timestamp_format) {
+    , layout_(TimestampFormatter(custom_timestamp_format)) {
+}
+
+inline ConsoleSink::~ConsoleSink() {
+    flush();
 }
 
 inline void ConsoleSink::write(const LogEntry& entry) {
-    std::string formatted = format_log_entry(entry);
-    
-    if (use_stderr_for_errors_ && (entry.level >= LogLevel::L_WARN)) {
-        std::cerr << formatted << std::endl;
-    } else {
-        std::cout << formatted << std::endl;
+    bool to_stderr = use_stderr_for_errors_ && (entry.level >= LogLevel::L_WARN);
+    std::string& batch = to_stderr ? stderr_batch_ : stdout_batch_;
+    format_log_entry(entry, batch);
+    if (batch.size() >= max_batch_size_) [[unlikely]] {
+        write_fd(to_stderr ? 2 : 1, batch);
     }
 }
 
 inline void ConsoleSink::flush() {
-    std::cout.flush();
-    std::cerr.flush();
+    // One write per stream per batch instead of an iostream lock and flush per line
+    if (!stdout_batch_.empty()) {
+        write_fd(1, stdout_batch_);
+    }
+    if (!stderr_batch_.empty()) {
+        write_fd(2, stderr_batch_);
+    }
 }
 
-inline std::string ConsoleSink::format_log_entry(const LogEntry& entry) {
-    std::string level_str = to_string(entry.level);
-    std::string timestamp = timestamp_formatter_.format_timestamp(entry.timestamp);
-    auto [message, good] = format_log_message(entry);
-    if (!good) [[unlikely]] {
-        level_str = "ERROR";
+inline void ConsoleSink::format_log_entry(const LogEntry& entry, std::string& out) {
+    if (use_colors_) {
+        out += get_color_code(entry.level);
     }
-    std::string result = timestamp + " [" + level_str + "] " + message;
-    
+    layout_.format(entry, *this, out);
     if (use_colors_) {
-        return get_color_code(entry.level) + result + get_reset_code();
+        out += reset_code_;
     }
-    
-    return result;
+    out += '\n';
 }
 
-inline std::string ConsoleSink::get_color_code(LogLevel level) {
+inline std::string_view ConsoleSink::get_color_code(LogLevel level) noexcept {
     switch (level) {
         case LogLevel::L_TRACE: return "\033[90m";   // Dark gray
         case LogLevel::L_DEBUG: return "\033[36m";   // Cyan
@@ -852,13 +2714,30 @@ inline std::string ConsoleSink::get_color_code(LogLevel level) {
     }
 }
 
-inline std::string ConsoleSink::get_reset_code() {
-    return "\033[0m";
+inline void ConsoleSink::write_fd(int fd, std::string& batch) noexcept {
+    const char* data = batch.data();
+    size_t remaining = batch.size();
+    while (remaining > 0) {
+#ifdef _WIN32
+        int written = _write(fd, data, static_cast<unsigned int>(remaining));
+#else
+        auto written = ::write(fd, data, remaining);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (written <= 0) {
+            break; // Console gone or not writable - drop the batch rather than stall the writer
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    batch.clear(); // Keeps capacity for the next batch
 }
 
 inline FileSink::FileSink(const std::filesystem::path& file_path,
                           TimestampFormatter::Format timestamp_format, std::string&& name)
-    : ISink(std::move(name)), file_path_(file_path), timestamp_formatter_(timestamp_format) {
+    : ISink(std::move(name)), file_path_(file_path), layout_(TimestampFormatter(timestamp_format)) {
     file_stream_.open(file_path_, std::ios::app);
     if (!file_stream_) {
         throw std::runtime_error("Failed to open log file: " + file_path_.string());
@@ -867,7 +2746,7 @@ inline FileSink::FileSink(const std::filesystem::path& file_path,
 
 inline FileSink::FileSink(const std::filesystem::path& file_path,
                           const std::string& custom_timestamp_format, std::string&& name)
-    : ISink(std::move(name)), file_path_(file_path), timestamp_formatter_(custom_timestamp_format) {
+    : ISink(std::move(name)), file_path_(file_path), layout_(TimestampFormatter(custom_timestamp_format)) {
     file_stream_.open(file_path_, std::ios::app);
     if (!file_stream_) {
         throw std::runtime_error("Failed to open log file: " + file_path_.string());
@@ -886,82 +2765,367 @@ inline void FileSink::flush() {
     }
 }
 
-inline std::string FileSink::format_log_entry(const LogEntry& entry) {
-    std::string level_str = to_string(entry.level);
-    std::string timestamp = timestamp_formatter_.format_timestamp(entry.timestamp);
-    auto [message, good] = format_log_message(entry);
-    if (!good) [[unlikely]] {
-        level_str = "ERROR";
-    }
-    return timestamp + " [" + level_str + "] " + message;
+inline const std::string& FileSink::format_log_entry(const LogEntry& entry) {
+    format_buffer_.clear();
+    layout_.format(entry, *this, format_buffer_);
+    return format_buffer_;
 }
 
-inline RotatingFileSink::RotatingFileSink(const std::filesystem::path& base_path, const RotationConfig& config,
-                                          TimestampFormatter::Format timestamp_format, std::string&& name)
-    : FileSink(base_path, timestamp_format, std::move(name)), config_(config), base_path_(base_path), current_file_size_(0) {
-    if (std::filesystem::exists(base_path_)) {
-        current_file_size_ = std::filesystem::file_size(base_path_);
-    }
+inline void lower_current_thread_priority() noexcept {
+#ifdef __linux__
+    // Stay out of the way of latency sensitive threads, for both CPU and disk I/O
+#ifdef SCHED_IDLE
+    sched_param param{};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+#ifdef SYS_ioprio_set
+    constexpr int IOPRIO_WHO_PROCESS = 1;   // with id 0 applies to the calling thread
+    constexpr int IOPRIO_CLASS_IDLE = 3;
+    syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << 13);
+#endif
+#endif
 }
 
-inline RotatingFileSink::RotatingFileSink(const std::filesystem::path& base_path, const RotationConfig& config,
-                                        const std::string& custom_timestamp_format, std::string&& name)
-    : FileSink(base_path, custom_timestamp_format, std::move(name)), config_(config), base_path_(base_path), current_file_size_(0) {
-    if (std::filesystem::exists(base_path_)) {
-        current_file_size_ = std::filesystem::file_size(base_path_);
-    }
+inline BackgroundWorker::BackgroundWorker()
+    : thread_([this]() { run(); }) {
 }
 
-inline void RotatingFileSink::write(const LogEntry& entry) {
-    check_rotation();
-    
-    if (file_stream_) {
-        std::string formatted = format_log_entry(entry);
-        file_stream_ << formatted << std::endl;
-        current_file_size_ += formatted.length() + 1; // +1 for newline
+inline BackgroundWorker::~BackgroundWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
     }
 }
 
-inline void RotatingFileSink::check_rotation() {
-    if (current_file_size_ >= config_.max_file_size) {
-        rotate_files();
+inline void BackgroundWorker::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
     }
+    cv_.notify_one();
 }
 
-inline void RotatingFileSink::rotate_files() {
-    file_stream_.close();
-    
-    // Remove the oldest file if it exists
-    auto oldest_file = get_rotated_filename(config_.max_files - 1);
-    if (std::filesystem::exists(oldest_file)) {
-        std::filesystem::remove(oldest_file);
-    }
-    
-    // Rotate existing files
-    for (size_t i = config_.max_files - 1; i > 0; --i) {
-        auto src = (i == 1) ? base_path_ : get_rotated_filename(i - 1);
-        auto dst = get_rotated_filename(i);
-        
-        if (std::filesystem::exists(src)) {
-            std::filesystem::rename(src, dst);
+inline void BackgroundWorker::run() {
+    lower_current_thread_priority();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+            break;  // stopped and drained
+        }
+
+        auto task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        try {
+            task();
+        } catch (...) {
+            // File housekeeping failures must not take the process down
         }
+        lock.lock();
     }
-    
-    // Create new current file
-    file_stream_.open(base_path_, std::ios::out | std::ios::trunc);
-    current_file_size_ = 0;
 }
 
-inline std::filesystem::path RotatingFileSink::get_rotated_filename(size_t index) {
+inline BackgroundCompressor::BackgroundCompressor()
+    : thread_([this]() { run(); }) {
+}
+
+inline BackgroundCompressor::~BackgroundCompressor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+inline void BackgroundCompressor::submit(const std::filesystem::path& file) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(file);
+    }
+    cv_.notify_one();
+}
+
+inline void BackgroundCompressor::retarget(const std::filesystem::path& from, const std::filesystem::path& to) {
+    if (!in_flight_.empty() && in_flight_ == from) {
+        in_flight_ = to;
+    }
+    for (auto& file : pending_) {
+        if (file == from) {
+            file = to;
+        }
+    }
+}
+
+inline bool BackgroundCompressor::contains(const std::filesystem::path& file) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (in_flight_ == file) {
+        return true;
+    }
+    for (const auto& pending : pending_) {
+        if (pending == file) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void BackgroundCompressor::run() {
+    lower_current_thread_priority();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return stop_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            break;  // stopped and drained
+        }
+
+        in_flight_ = std::move(pending_.front());
+        pending_.pop_front();
+        if (in_flight_.empty()) {
+            continue;   // removed by rotation before we got to it
+        }
+
+        // Move the file out of the rotation sequence while compressing, so the sink can keep
+        // renaming its slots without touching a file we have open
+        std::filesystem::path staged = std::filesystem::path(in_flight_) += ".compressing";
+        std::error_code ec;
+        std::filesystem::rename(in_flight_, staged, ec);
+        if (ec) {
+            in_flight_.clear();
+            continue;
+        }
+
+        std::filesystem::path tmp = std::filesystem::path(staged) += ".gz.tmp";
+        lock.unlock();
+        bool ok = compress_file(staged, tmp);
+        lock.lock();
+
+        if (in_flight_.empty()) {
+            // Rotated out of retention while we were compressing
+            std::filesystem::remove(staged, ec);
+            std::filesystem::remove(tmp, ec);
+        } else if (ok) {
+            std::filesystem::rename(tmp, archive_path(in_flight_), ec);
+            if (!ec) {
+                std::filesystem::remove(staged, ec);
+            } else {
+                std::filesystem::remove(tmp, ec);
+                std::filesystem::rename(staged, in_flight_, ec);
+            }
+        } else {
+            // Keep the uncompressed file rather than losing it
+            std::filesystem::remove(tmp, ec);
+            std::filesystem::rename(staged, in_flight_, ec);
+        }
+        in_flight_.clear();
+    }
+}
+
+inline bool BackgroundCompressor::compress_file(const std::filesystem::path& src, const std::filesystem::path& dst) {
+#ifdef SLICK_LOGGER_HAS_ZLIB
+    std::ifstream in(src, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    gzFile out = gzopen(dst.string().c_str(), "wb");
+    if (!out) {
+        return false;
+    }
+
+    bool ok = true;
+    std::vector<char> buffer(64 * 1024);
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        auto n = static_cast<int>(in.gcount());
+        if (n > 0 && gzwrite(out, buffer.data(), static_cast<unsigned>(n)) != n) {
+            ok = false;
+            break;
+        }
+    }
+    if (gzclose(out) != Z_OK) {
+        ok = false;
+    }
+    return ok;
+#else
+    (void)src;
+    (void)dst;
+    return false;
+#endif
+}
+
+inline bool rotated_file_exists(const std::filesystem::path& file, const BackgroundCompressor* compressor) {
+    if (std::filesystem::exists(file)) {
+        return true;
+    }
+    // Check the compressor before the archive: a job may complete in between, but never un-complete
+    return compressor && (compressor->contains(file) ||
+                          std::filesystem::exists(BackgroundCompressor::archive_path(file)));
+}
+
+inline void rename_rotated_file(const std::filesystem::path& src, const std::filesystem::path& dst, BackgroundCompressor* compressor) {
+    if (std::filesystem::exists(src)) {
+        std::filesystem::rename(src, dst);
+    }
+    if (compressor) {
+        auto src_archive = BackgroundCompressor::archive_path(src);
+        if (std::filesystem::exists(src_archive)) {
+            std::filesystem::rename(src_archive, BackgroundCompressor::archive_path(dst));
+        }
+        compressor->retarget(src, dst);
+    }
+}
+
+inline void remove_rotated_file(const std::filesystem::path& file, BackgroundCompressor* compressor) {
+    if (std::filesystem::exists(file)) {
+        std::filesystem::remove(file);
+    }
+    if (compressor) {
+        auto archive = BackgroundCompressor::archive_path(file);
+        if (std::filesystem::exists(archive)) {
+            std::filesystem::remove(archive);
+        }
+        compressor->retarget(file, {});
+    }
+}
+
+inline RotatingFileSink::RotatingFileSink(const std::filesystem::path& base_path, const RotationConfig& config,
+                                          TimestampFormatter::Format timestamp_format, std::string&& name)
+    : FileSink(base_path, timestamp_format, std::move(name)), config_(config), base_path_(base_path), current_file_size_(0)
+    , compressor_(BackgroundCompressor::create(config)), janitor_(std::make_unique<BackgroundWorker>()) {
+    if (std::filesystem::exists(base_path_)) {
+        current_file_size_ = std::filesystem::file_size(base_path_);
+    }
+    recover_staged_files();
+}
+
+inline RotatingFileSink::RotatingFileSink(const std::filesystem::path& base_path, const RotationConfig& config,
+                                        const std::string& custom_timestamp_format, std::string&& name)
+    : FileSink(base_path, custom_timestamp_format, std::move(name)), config_(config), base_path_(base_path), current_file_size_(0)
+    , compressor_(BackgroundCompressor::create(config)), janitor_(std::make_unique<BackgroundWorker>()) {
+    if (std::filesystem::exists(base_path_)) {
+        current_file_size_ = std::filesystem::file_size(base_path_);
+    }
+    recover_staged_files();
+}
+
+inline void RotatingFileSink::write(const LogEntry& entry) {
+    check_rotation();
+    
+    if (file_stream_) {
+        const std::string& formatted = format_log_entry(entry);
+        file_stream_ << formatted << std::endl;
+        current_file_size_ += formatted.length() + 1; // +1 for newline
+    }
+}
+
+inline void RotatingFileSink::check_rotation() {
+    if (current_file_size_ >= config_.max_file_size) {
+        rotate_files();
+    }
+}
+
+inline void RotatingFileSink::rotate_files() {
+    file_stream_.close();
+
+    // Move the full file out of the way and start the new one right away. The rename cascade
+    // and retention cleanup run on the janitor thread, so the writer never waits on them.
+    auto staged = get_staged_filename(++rotation_seq_);
+    std::error_code ec;
+    std::filesystem::rename(base_path_, staged, ec);
+    if (ec) {
+        // Keep appending to the current file and try again after another max_file_size bytes
+        file_stream_.open(base_path_, std::ios::app);
+        current_file_size_ = 0;
+        return;
+    }
+
+    file_stream_.open(base_path_, std::ios::out | std::ios::trunc);
+    current_file_size_ = 0;
+
+    janitor_->post([this, staged]() { shift_rotated_files(staged); });
+}
+
+inline void RotatingFileSink::shift_rotated_files(const std::filesystem::path& staged) {
+    if (config_.max_files <= 1) {
+        // No rotated files are kept
+        std::filesystem::remove(staged);
+        return;
+    }
+
+    {
+        // The compressor only takes this lock briefly, to move a file in or out of the sequence
+        std::unique_lock<std::mutex> lock;
+        if (compressor_) {
+            lock = std::unique_lock<std::mutex>(compressor_->mutex());
+        }
+
+        // Remove the oldest file if it exists
+        auto oldest_file = get_rotated_filename(config_.max_files - 1);
+        remove_rotated_file(oldest_file, compressor_.get());
+
+        // Rotate existing files
+        for (size_t i = config_.max_files - 1; i > 0; --i) {
+            auto src = (i == 1) ? staged : get_rotated_filename(i - 1);
+            auto dst = get_rotated_filename(i);
+            rename_rotated_file(src, dst, compressor_.get());
+        }
+    }
+
+    if (compressor_) {
+        compressor_->submit(get_rotated_filename(1));
+    }
+}
+
+inline void RotatingFileSink::recover_staged_files() {
+    // Files staged for rotation by a previous run that exited before the janitor got to them
+    std::string prefix = base_path_.filename().string() + ".";
+    std::vector<uint64_t> seqs;
+    std::error_code ec;
+    auto dir = base_path_.parent_path().empty() ? std::filesystem::path(".") : base_path_.parent_path();
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        auto filename = entry.path().filename().string();
+        if (filename.size() > prefix.size() && filename.starts_with(prefix) && filename.ends_with(".rotating")) {
+            auto seq = filename.substr(prefix.size(), filename.size() - prefix.size() - std::strlen(".rotating"));
+            if (!seq.empty() && seq.find_first_not_of("0123456789") == std::string::npos) {
+                seqs.push_back(std::stoull(seq));
+            }
+        }
+    }
+
+    std::sort(seqs.begin(), seqs.end());
+    for (auto seq : seqs) {
+        auto staged = get_staged_filename(seq);
+        janitor_->post([this, staged]() { shift_rotated_files(staged); });
+        rotation_seq_ = seq;
+    }
+}
+
+inline std::filesystem::path RotatingFileSink::get_rotated_filename(size_t index) const {
     std::string filename = base_path_.stem().string() + "_" + std::to_string(index) + base_path_.extension().string();
     return base_path_.parent_path() / filename;
 }
 
+inline std::filesystem::path RotatingFileSink::get_staged_filename(uint64_t seq) const {
+    return std::filesystem::path(base_path_) += "." + std::to_string(seq) + ".rotating";
+}
+
 inline DailyFileSink::DailyFileSink(const std::filesystem::path& base_path, const RotationConfig& config,
                                     TimestampFormatter::Format timestamp_format, std::string&& name)
     : FileSink(base_path, timestamp_format, std::move(name)), config_(config), base_path_(base_path),
-      current_file_size_(0) {
-    current_date_ = get_date_string();
+      current_file_size_(0), compressor_(BackgroundCompressor::create(config)) {
+    uint64_t now = now_ns();
+    current_date_ = get_date_string(now);
+    next_rotation_ns_ = get_next_midnight(now);
 
     // Check if file already exists and is from a previous day
     if (std::filesystem::exists(base_path_)) {
@@ -983,7 +3147,7 @@ inline DailyFileSink::DailyFileSink(const std::filesystem::path& base_path, cons
 
                 // Check if dated file already exists, if so rotate all files for that date
                 std::filesystem::path dated_file = get_dated_filename(file_date);
-                if (std::filesystem::exists(dated_file)) {
+                if (rotated_file_exists(dated_file, compressor_.get())) {
                     rotate_files_for_date(file_date);
                 }
 
@@ -997,6 +3161,9 @@ inline DailyFileSink::DailyFileSink(const std::filesystem::path& base_path, cons
                         std::filesystem::remove(base_path_, ec);
                     }
                 }
+                if (compressor_) {
+                    compressor_->submit(dated_file);
+                }
 
                 // Reopen file for today
                 file_stream_.open(base_path_, std::ios::out | std::ios::trunc);
@@ -1021,8 +3188,11 @@ inline DailyFileSink::DailyFileSink(const std::filesystem::path& base_path, cons
     : FileSink(base_path, custom_timestamp_format, std::move(name))
     , config_(config)
     , base_path_(base_path)
-    , current_file_size_(0) {
-    current_date_ = get_date_string();
+    , current_file_size_(0)
+    , compressor_(BackgroundCompressor::create(config)) {
+    uint64_t now = now_ns();
+    current_date_ = get_date_string(now);
+    next_rotation_ns_ = get_next_midnight(now);
 
     // Check if file already exists and is from a previous day
     if (std::filesystem::exists(base_path_)) {
@@ -1044,7 +3214,7 @@ inline DailyFileSink::DailyFileSink(const std::filesystem::path& base_path, cons
 
                 // Check if dated file already exists, if so rotate all files for that date
                 std::filesystem::path dated_file = get_dated_filename(file_date);
-                if (std::filesystem::exists(dated_file)) {
+                if (rotated_file_exists(dated_file, compressor_.get())) {
                     rotate_files_for_date(file_date);
                 }
 
@@ -1058,6 +3228,9 @@ inline DailyFileSink::DailyFileSink(const std::filesystem::path& base_path, cons
                         std::filesystem::remove(base_path_, ec);
                     }
                 }
+                if (compressor_) {
+                    compressor_->submit(dated_file);
+                }
 
                 // Reopen file for today
                 file_stream_.open(base_path_, std::ios::out | std::ios::trunc);
@@ -1078,19 +3251,31 @@ inline DailyFileSink::DailyFileSink(const std::filesystem::path& base_path, cons
 }
 
 inline void DailyFileSink::write(const LogEntry& entry) {
-    check_rotation();
+    check_rotation(entry.timestamp);
 
     if (file_stream_) {
-        std::string formatted = format_log_entry(entry);
+        const std::string& formatted = format_log_entry(entry);
         file_stream_ << formatted << std::endl;
         current_file_size_ += formatted.length() + 1; // +1 for newline
     }
 }
 
-inline void DailyFileSink::check_rotation() {
-    std::string today = get_date_string();
+inline void DailyFileSink::check_rotation(uint64_t timestamp_ns) {
+    // Check for date-based rotation, following log time rather than wall time
+    if (timestamp_ns >= next_rotation_ns_) [[unlikely]] {
+        rotate_to_new_day(timestamp_ns);
+    }
+
+    // Check for size-based rotation
+    if (config_.max_file_size && current_file_size_ >= config_.max_file_size) {
+        rotate_daily_files();
+    }
+}
+
+inline void DailyFileSink::rotate_to_new_day(uint64_t timestamp_ns) {
+    std::string today = get_date_string(timestamp_ns);
+    next_rotation_ns_ = get_next_midnight(timestamp_ns);
 
-    // Check for date-based rotation
     if (today != current_date_) {
         // Close current file
         file_stream_.close();
@@ -1099,6 +3284,11 @@ inline void DailyFileSink::check_rotation() {
         std::filesystem::path old_dated_file = get_dated_filename(current_date_);
         std::error_code ec;
         if (std::filesystem::exists(base_path_)) {
+            // Size rotation may already have produced a dated file for that day - shift it rather than overwrite
+            if (rotated_file_exists(old_dated_file, compressor_.get())) {
+                rotate_files_for_date(current_date_);
+            }
+
             std::filesystem::rename(base_path_, old_dated_file, ec);
             if (ec) {
                 // If rename fails, try copy and remove
@@ -1107,156 +3297,1260 @@ inline void DailyFileSink::check_rotation() {
                     std::filesystem::remove(base_path_, ec);
                 }
             }
+            if (compressor_) {
+                compressor_->submit(old_dated_file);
+            }
+        }
+
+        // Reopen base file for new day's logs
+        file_stream_.open(base_path_, std::ios::out | std::ios::trunc); // Start fresh for new day
+        if (!file_stream_) {
+            throw std::runtime_error("Failed to reopen daily log file: " + base_path_.string());
+        }
+
+        current_file_size_ = 0;
+        current_date_ = today;
+    }
+}
+
+inline void DailyFileSink::rotate_files_for_date(const std::string& date) {
+    // Remove the oldest file if it exists and max_files is configured
+    // Files are: daily_DATE.log (index 0), daily_DATE_001.log (index 1), ..., daily_DATE_<max_files-1>.log (index max_files-1)
+
+    auto dated_file = get_dated_filename(date);
+
+    // The compressor only takes this lock briefly, to move a file in or out of the sequence
+    std::unique_lock<std::mutex> lock;
+    if (compressor_) {
+        lock = std::unique_lock<std::mutex>(compressor_->mutex());
+    }
+
+    if (config_.max_files == 1) {
+        // If max_files is 1, we only keep the dated file (no indexed files)
+        // Just remove the old dated file - it will be replaced by the new one
+        remove_rotated_file(dated_file, compressor_.get());
+    } else if (config_.max_files > 1) {
+        // Remove the oldest indexed file
+        auto oldest_file = get_dated_indexed_filename(date, config_.max_files - 1);
+        remove_rotated_file(oldest_file, compressor_.get());
+
+        // Rotate existing indexed files for the given date
+        // Start from the highest index and work down to 2
+        for (size_t i = config_.max_files - 1; i >= 2; --i) {
+            auto src = get_dated_indexed_filename(date, i - 1);
+            auto dst = get_dated_indexed_filename(date, i);
+            rename_rotated_file(src, dst, compressor_.get());
+        }
+
+        // Rotate the dated file (without index) to _001.log
+        rename_rotated_file(dated_file, get_dated_indexed_filename(date, 1), compressor_.get());
+    }
+}
+
+inline void DailyFileSink::rotate_daily_files() {
+    file_stream_.close();
+
+    // Rotate all existing files for the current date (if any)
+    std::filesystem::path dated_file = get_dated_filename(current_date_);
+
+    // Always rotate if dated file exists, which will shift:
+    // daily_2025-10-02.log -> _001.log
+    // _001.log -> _002.log, etc.
+    if (rotated_file_exists(dated_file, compressor_.get())) {
+        rotate_files_for_date(current_date_);
+    }
+
+    // Rename current base file to dated filename (e.g., daily.log -> daily_2025-10-02.log)
+    std::error_code ec;
+    if (std::filesystem::exists(base_path_)) {
+        std::filesystem::rename(base_path_, dated_file, ec);
+        if (ec) {
+            // If rename fails, try copy and remove
+            std::filesystem::copy_file(base_path_, dated_file, ec);
+            if (!ec) {
+                std::filesystem::remove(base_path_, ec);
+            }
+        }
+        if (compressor_) {
+            compressor_->submit(dated_file);
+        }
+    }
+
+    // Create new current file
+    file_stream_.open(base_path_, std::ios::out | std::ios::trunc);
+    if (!file_stream_) {
+        throw std::runtime_error("Failed to reopen daily log file: " + base_path_.string());
+    }
+    current_file_size_ = 0;
+}
+
+inline std::filesystem::path DailyFileSink::get_daily_filename(uint64_t timestamp_ns) const {
+    std::string date_str = get_date_string(timestamp_ns);
+    return get_dated_filename(date_str);
+}
+
+inline std::filesystem::path DailyFileSink::get_dated_filename(const std::string& date) const {
+    std::string filename = base_path_.stem().string() + "_" + date + base_path_.extension().string();
+    return base_path_.parent_path() / filename;
+}
+
+inline std::filesystem::path DailyFileSink::get_dated_indexed_filename(const std::string& date, size_t index) const {
+    std::ostringstream oss;
+    oss << base_path_.stem().string() << "_" << date << "_" << std::setfill('0') << std::setw(3) << index << base_path_.extension().string();
+    return base_path_.parent_path() / oss.str();
+}
+
+inline std::string DailyFileSink::get_date_string(uint64_t timestamp_ns) const {
+    time_t time_val = static_cast<time_t>(timestamp_ns / 1000000000ULL);
+    std::tm* tm_ptr = std::localtime(&time_val);
+    if (!tm_ptr) {
+        return "1970-01-01"; // fallback date
+    }
+    std::tm tm = *tm_ptr;
+
+    char date_str[11];
+    std::strftime(date_str, sizeof(date_str), "%Y-%m-%d", &tm);
+    return std::string(date_str);
+}
+
+inline uint64_t DailyFileSink::get_next_midnight(uint64_t timestamp_ns) const {
+    time_t time_val = static_cast<time_t>(timestamp_ns / 1000000000ULL);
+    std::tm* tm_ptr = std::localtime(&time_val);
+    if (!tm_ptr) {
+        return UINT64_MAX; // never rotate by date
+    }
+    std::tm tm = *tm_ptr;
+
+    // mktime normalizes the day overflow and resolves DST for the new day
+    tm.tm_mday += 1;
+    tm.tm_hour = 0;
+    tm.tm_min = 0;
+    tm.tm_sec = 0;
+    tm.tm_isdst = -1;
+    time_t midnight = std::mktime(&tm);
+    if (midnight == static_cast<time_t>(-1)) {
+        return UINT64_MAX;
+    }
+    return static_cast<uint64_t>(midnight) * 1000000000ULL;
+}
+
+inline void append_json_escaped(std::string& out, std::string_view str) {
+    static constexpr char hex_digits[] = "0123456789abcdef";
+
+    const char* p = str.data();
+    const char* end = p + str.size();
+    while (p < end) {
+        // Find the next character that needs escaping: '"', '\\' or a control character
+        const char* run = p;
+#ifdef SLICK_LOGGER_HAS_SSE2
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control_max = _mm_set1_epi8(0x1F);
+        while (end - p >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i is_control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control_max), control_max);
+            __m128i needs_escape = _mm_or_si128(is_control,
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+            int mask = _mm_movemask_epi8(needs_escape);
+            if (mask != 0) {
+                p += std::countr_zero(static_cast<unsigned>(mask));
+                goto found;
+            }
+            p += 16;
+        }
+#endif
+        while (p < end) {
+            auto c = static_cast<unsigned char>(*p);
+            if (c < 0x20 || c == '"' || c == '\\') {
+                break;
+            }
+            ++p;
+        }
+#ifdef SLICK_LOGGER_HAS_SSE2
+    found:
+#endif
+        out.append(run, p - run);
+        if (p == end) {
+            break;
+        }
+
+        auto c = static_cast<unsigned char>(*p++);
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default: {
+                char escaped[6] = { '\\', 'u', '0', '0', hex_digits[c >> 4], hex_digits[c & 0xF] };
+                out.append(escaped, sizeof(escaped));
+                break;
+            }
+        }
+    }
+}
+
+inline void append_hex(std::string& out, const uint8_t* data, size_t size, bool uppercase) {
+    const char* digits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    size_t pos = out.size();
+    out.resize(pos + size * 2);
+    char* dest = out.data() + pos;
+    size_t i = 0;
+#ifdef SLICK_LOGGER_HAS_SSE2
+    // Nibble n becomes '0' + n, plus the gap to 'a' (or 'A') when n > 9
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    const __m128i ascii_zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i letter_gap = _mm_set1_epi8(uppercase ? 'A' - '0' - 10 : 'a' - '0' - 10);
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(chunk, 4), low_mask);
+        __m128i lo = _mm_and_si128(chunk, low_mask);
+        hi = _mm_add_epi8(_mm_add_epi8(hi, ascii_zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letter_gap));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, ascii_zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letter_gap));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#endif
+    for (; i < size; ++i) {
+        dest[i * 2] = digits[data[i] >> 4];
+        dest[i * 2 + 1] = digits[data[i] & 0x0F];
+    }
+}
+
+inline void append_hexdump(std::string& out, const uint8_t* data, size_t size) {
+    // 00000000  48 65 6c 6c 6f 20 57 6f  72 6c 64 0a 00 01 02 03  |Hello World.....|
+    std::string hex;
+    for (size_t offset = 0; offset < size; offset += 16) {
+        size_t count = std::min<size_t>(16, size - offset);
+        hex.clear();
+        append_hex(hex, data + offset, count);
+
+        std::format_to(std::back_inserter(out), "\n{:08x} ", offset);
+        for (size_t i = 0; i < 16; ++i) {
+            out += i == 8 ? "  " : " ";
+            if (i < count) {
+                out.append(hex, i * 2, 2);
+            } else {
+                out += "  ";
+            }
+        }
+        out += "  |";
+        for (size_t i = 0; i < count; ++i) {
+            char c = static_cast<char>(data[offset + i]);
+            out += (c >= 0x20 && c < 0x7F) ? c : '.';
+        }
+        out += '|';
+    }
+}
+
+inline void append_array(std::string& out, const StringRef& payload, std::string_view spec) {
+    // {[:range-options[:element-spec]]}, as for std::format ranges
+    std::string_view inner = spec.substr(1, spec.size() - 2);
+    std::string_view options;
+    std::string_view element_spec;
+    if (!inner.empty()) {
+        if (inner.front() != ':') {
+            throw std::format_error("positional arguments are not supported for ranges");
+        }
+        inner.remove_prefix(1);
+        size_t colon = inner.find(':');
+        options = inner.substr(0, colon);
+        if (colon != std::string_view::npos) {
+            element_spec = inner.substr(colon);
+        }
+    }
+    if (!options.empty() && options != "n") {
+        throw std::format_error("unsupported range format options");
+    }
+
+    std::string element_format;
+    element_format.reserve(element_spec.size() + 2);
+    element_format += '{';
+    element_format += element_spec;
+    element_format += '}';
+
+    bool brackets = options.empty();
+    if (brackets) {
+        out += '[';
+    }
+    bool first = true;
+    auto it = std::back_inserter(out);
+    for_each_array_element(payload, [&](auto value) {
+        if (!first) {
+            out += ", ";
+        }
+        first = false;
+        std::vformat_to(it, element_format, std::make_format_args(value));
+    });
+    if (payload.truncated) {
+        out += first ? "..." : ", ...";
+    }
+    if (brackets) {
+        out += ']';
+    }
+}
+
+inline void append_decimal(std::string& out, Decimal value, int precision) {
+    static constexpr uint64_t pow10[] = {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+        1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+        100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+        1000000000000000000ull, 10000000000000000000ull
+    };
+    constexpr int max_pow10 = 19;
+
+    // Magnitude, valid for INT64_MIN as well
+    uint64_t magnitude = value.mantissa < 0 ? 0 - static_cast<uint64_t>(value.mantissa) : static_cast<uint64_t>(value.mantissa);
+    int scale = value.exponent < 0 ? -value.exponent : 0;    // fractional digits held by magnitude
+    int trailing_zeros = value.exponent > 0 ? value.exponent : 0;
+    if (precision < 0) {
+        precision = scale;
+    }
+
+    if (precision < scale) {
+        // Drop digits, rounding half away from zero
+        int drop = scale - precision;
+        if (drop > max_pow10) {
+            magnitude = 0;
+        } else {
+            uint64_t divisor = pow10[drop];
+            uint64_t remainder = magnitude % divisor;
+            magnitude /= divisor;
+            if (remainder >= divisor - remainder) {
+                ++magnitude;
+            }
+        }
+        scale = precision;
+    }
+
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), magnitude);
+    int digit_count = static_cast<int>(result.ptr - digits);
+
+    if (value.mantissa < 0) {
+        out += '-';
+    }
+    if (digit_count > scale) {
+        out.append(digits, digit_count - scale);
+        if (magnitude != 0) {
+            out.append(trailing_zeros, '0');
+        }
+    } else {
+        out += '0';
+    }
+    if (precision > 0) {
+        out += '.';
+        if (digit_count < scale) {
+            out.append(scale - digit_count, '0');
+        }
+        int shown = std::min(digit_count, scale);
+        out.append(digits + digit_count - shown, shown);
+        out.append(precision - scale, '0');
+    }
+}
+
+inline void append_decimal(std::string& out, Decimal value, std::string_view spec) {
+    // {[:[[fill]align][width][.precision][f]]}
+    std::string_view inner = spec.substr(1, spec.size() - 2);
+    if (inner.empty()) {
+        append_decimal(out, value);
+        return;
+    }
+    if (inner.front() != ':') {
+        throw std::format_error("positional arguments are not supported for decimals");
+    }
+    inner.remove_prefix(1);
+
+    // Parsed from the left, so '.' can be the fill character
+    auto is_align = [](char c) { return c == '<' || c == '>' || c == '^'; };
+    auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+    size_t pos = 0;
+    if (inner.size() >= 2 && is_align(inner[1])) {
+        pos = 2;
+    } else if (!inner.empty() && is_align(inner[0])) {
+        pos = 1;
+    }
+    while (pos < inner.size() && is_digit(inner[pos])) {
+        ++pos;
+    }
+    size_t field_end = pos;
+
+    int precision = -1;
+    if (pos < inner.size() && inner[pos] == '.') {
+        size_t digits_start = ++pos;
+        while (pos < inner.size() && is_digit(inner[pos])) {
+            ++pos;
+        }
+        auto result = std::from_chars(inner.data() + digits_start, inner.data() + pos, precision);
+        if (pos == digits_start || result.ec != std::errc()) {
+            throw std::format_error("invalid precision for decimal");
+        }
+    }
+    if (pos < inner.size() && inner[pos] == 'f') {
+        ++pos;
+    }
+    if (pos != inner.size()) {
+        throw std::format_error("invalid format spec for decimal");
+    }
+    inner = inner.substr(0, field_end);
+
+    if (inner.empty()) {
+        append_decimal(out, value, precision);
+        return;
+    }
+
+    // Fill, align and width are applied to the rendered digits
+    std::string text;
+    append_decimal(text, value, precision);
+    std::string field;
+    field.reserve(inner.size() + 3);
+    field += "{:";
+    field += inner;
+    field += '}';
+    std::string_view text_view = text;
+    std::vformat_to(std::back_inserter(out), field, std::make_format_args(text_view));
+}
+
+inline JsonLinesSink::JsonLinesSink(const std::filesystem::path& file_path, std::string&& name)
+    : FileSink(file_path, TimestampFormatter::Format::WITH_MICROSECONDS, std::move(name)) {
+    line_buffer_.reserve(1024);
+    message_buffer_.reserve(512);
+}
+
+inline void JsonLinesSink::write(const LogEntry& entry) {
+    if (file_stream_) {
+        line_buffer_.clear();
+        format_json_entry(entry, line_buffer_);
+        file_stream_.write(line_buffer_.data(), static_cast<std::streamsize>(line_buffer_.size()));
+    }
+}
+
+inline void JsonLinesSink::format_json_entry(const LogEntry& entry, std::string& out) {
+    message_buffer_.clear();
+    bool good = format_log_message(entry, message_buffer_);
+
+    out += "{\"timestamp\":";
+    std::format_to(std::back_inserter(out), "{},\"thread\":{}", entry.timestamp, entry.thread_id);
+    std::string_view thread_name = ThreadRegistry::instance().name(entry.thread_id);
+    if (!thread_name.empty()) {
+        out += ",\"thread_name\":\"";
+        append_json_escaped(out, thread_name);
+        out += '"';
+    }
+    out += ",\"level\":\"";
+    out += good ? to_string(entry.level) : "ERROR";
+    out += "\",\"message\":\"";
+    append_json_escaped(out, message_buffer_);
+    out += '"';
+
+    if (entry.context_id != 0) {
+        if (auto context = ContextRegistry::instance().find(entry.context_id)) {
+            out += ",\"context\":{";
+            for (size_t i = 0; i < context->fields.size(); ++i) {
+                if (i > 0) {
+                    out += ',';
+                }
+                out += '"';
+                append_json_escaped(out, context->fields[i].first);
+                out += "\":\"";
+                append_json_escaped(out, context->fields[i].second);
+                out += '"';
+            }
+            out += '}';
+        }
+    }
+
+    // Named arguments go in a "fields" object, so keys such as "level" cannot clash with the
+    // entry's own members; a key repeated within the entry keeps its first value
+    bool positional = false;
+    bool has_fields = false;
+    for (uint8_t i = 0; i < entry.arg_count; ++i) {
+        if (entry.args[i].type != ArgType::KEY || i + 1 >= entry.arg_count) {
+            positional = true;
+            continue;
         }
+        std::string_view key = entry.args[i].value.literal_ptr;
+        bool repeated = false;
+        for (uint8_t j = 0; j < i && !repeated; ++j) {
+            repeated = entry.args[j].type == ArgType::KEY && key == entry.args[j].value.literal_ptr;
+        }
+        ++i;
+        if (repeated) {
+            continue;
+        }
+        out += has_fields ? ",\"" : ",\"fields\":{\"";
+        has_fields = true;
+        append_json_escaped(out, key);
+        out += "\":";
+        append_json_value(entry.args[i], out);
+    }
+    if (has_fields) {
+        out += '}';
+    }
+
+    if (positional) {
+        out += ",\"args\":[";
+        bool first = true;
+        for (uint8_t i = 0; i < entry.arg_count; ++i) {
+            if (entry.args[i].type == ArgType::KEY) {
+                ++i;
+                continue;
+            }
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            append_json_value(entry.args[i], out);
+        }
+        out += ']';
+    }
+    out += "}\n";
+}
+
+inline void JsonLinesSink::append_json_value(const LogArgument& arg, std::string& out) {
+    auto it = std::back_inserter(out);
+    auto append_float = [&](double value) {
+        if (std::isfinite(value)) {
+            std::format_to(it, "{}", value);
+        } else {
+            out += "null"; // JSON has no NaN or infinity
+        }
+    };
+
+    switch (arg.type) {
+        case ArgType::BOOL:     out += arg.value.b ? "true" : "false"; break;
+        case ArgType::CHAR:
+            out += '"';
+            append_json_escaped(out, std::string_view(&arg.value.c, 1));
+            out += '"';
+            break;
+        case ArgType::U_CHAR:   std::format_to(it, "{}", static_cast<unsigned>(arg.value.uc)); break;
+        case ArgType::WCHAR:    std::format_to(it, "{}", static_cast<uint32_t>(arg.value.wc)); break;
+        case ArgType::INT8_T:   std::format_to(it, "{}", arg.value.i8); break;
+        case ArgType::INT16_T:  std::format_to(it, "{}", arg.value.i16); break;
+        case ArgType::INT32_T:  std::format_to(it, "{}", arg.value.i32); break;
+        case ArgType::INT64_T:  std::format_to(it, "{}", arg.value.i64); break;
+        case ArgType::UINT8_T:  std::format_to(it, "{}", arg.value.u8); break;
+        case ArgType::UINT16_T: std::format_to(it, "{}", arg.value.u16); break;
+        case ArgType::UINT32_T: std::format_to(it, "{}", arg.value.u32); break;
+        case ArgType::UINT64_T: std::format_to(it, "{}", arg.value.u64); break;
+        case ArgType::FLOAT:    append_float(arg.value.f); break;
+        case ArgType::DOUBLE:   append_float(arg.value.d); break;
+        case ArgType::PTR:      std::format_to(it, "\"{}\"", static_cast<const void*>(arg.value.ptr)); break;
+        case ArgType::STRING_LITERAL:
+            out += '"';
+            append_json_escaped(out, arg.value.literal_ptr);
+            out += '"';
+            break;
+        case ArgType::STRING_DYNAMIC:
+        case ArgType::STRING_PERSISTENT:
+            out += '"';
+            append_json_escaped(out, std::string_view(arg.value.dynamic_str.ptr, arg.value.dynamic_str.length));
+            out += arg.value.dynamic_str.truncated ? "...\"" : "\"";
+            break;
+        case ArgType::BYTES:
+            out += '"';
+            append_hex(out, reinterpret_cast<const uint8_t*>(arg.value.dynamic_str.ptr), arg.value.dynamic_str.length);
+            out += arg.value.dynamic_str.truncated ? "...\"" : "\"";
+            break;
+        case ArgType::DECIMAL:
+            // JSON numbers are arbitrary precision, keep the exact digits
+            append_decimal(out, arg.value.decimal);
+            break;
+        case ArgType::ARRAY: {
+            out += '[';
+            bool first = true;
+            for_each_array_element(arg.value.dynamic_str, [&](auto value) {
+                if (!first) {
+                    out += ',';
+                }
+                first = false;
+                LogArgument element{};
+                using V = decltype(value);
+                element.type = array_element_type<V>();
+                std::memcpy(&element.value, &value, sizeof(V));
+                append_json_value(element, out);
+            });
+            if (arg.value.dynamic_str.truncated) {
+                out += first ? "\"...\"" : ",\"...\"";
+            }
+            out += ']';
+            break;
+        }
+        default:
+            out += "null";
+            break;
+    }
+}
+
+inline FlightRecorderSink::FlightRecorderSink(const std::filesystem::path& dump_path, size_t capacity,
+                                              size_t string_capacity, std::string&& name)
+    : ISink(std::move(name)), dump_path_(dump_path), layout_(TimestampFormatter::Format::WITH_MICROSECONDS) {
+    capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+    entries_.resize(capacity);
+    arena_begin_.resize(capacity);
+    mask_ = capacity - 1;
+    arena_.resize(std::max<size_t>(string_capacity, 4096));
+}
+
+inline void FlightRecorderSink::write(const LogEntry& entry) {
+    {
+        std::lock_guard lock(mutex_);
+        uint64_t slot = head_ & mask_;
+        LogEntry& stored = entries_[slot];
+
+        // Only copy the arguments in use, the rest of the entry is never read
+        std::memcpy(&stored, &entry, offsetof(LogEntry, args) + entry.arg_count * sizeof(LogArgument));
+        arena_begin_[slot] = arena_pos_;
+        if (head_ - tail_ == entries_.size()) {
+            ++tail_;
+        }
+        if (!copy_strings(stored)) {
+            // Too large for the arena: record the entry with its string arguments replaced
+            for (uint8_t i = 0; i < stored.arg_count; ++i) {
+                if (is_queued_data(stored.args[i].type)) {
+                    stored.args[i].type = ArgType::STRING_LITERAL;
+                    stored.args[i].value.literal_ptr = "<TRUNCATED>";
+                }
+            }
+        }
+        ++head_;
+    }
+
+    if (entry.level >= LogLevel::L_FATAL) {
+        dump();
+    }
+}
+
+inline bool FlightRecorderSink::copy_strings(LogEntry& entry) {
+    const uint64_t arena_size = arena_.size();
+    const uint64_t entry_begin = arena_pos_;
+    for (uint8_t i = 0; i < entry.arg_count; ++i) {
+        LogArgument& arg = entry.args[i];
+        if (!is_queued_data(arg.type)) {
+            continue;
+        }
+        uint64_t len = uint64_t(arg.value.dynamic_str.length) + 1;
+        if (len > arena_size / 4) {
+            return false;
+        }
+        uint64_t offset = arena_pos_ % arena_size;
+        if (offset + len > arena_size) {
+            arena_pos_ += arena_size - offset;  // strings never straddle the end of the arena
+            offset = 0;
+        }
+        if (arena_pos_ + len - entry_begin > arena_size) {
+            return false;   // would overwrite this entry's own strings
+        }
+        evict_strings_before(arena_pos_ + len);
+        std::memcpy(arena_.data() + offset, arg.value.dynamic_str.ptr, len - 1);
+        arena_[offset + len - 1] = '\0';
+        arg.value.dynamic_str.ptr = arena_.data() + offset;
+        arena_pos_ += len;
+    }
+    return true;
+}
+
+inline void FlightRecorderSink::evict_strings_before(uint64_t arena_end) {
+    // Drop the oldest entries whose strings are about to be overwritten
+    // (the entry being written is at head_, so it is never evicted here)
+    while (tail_ < head_ && arena_end - arena_begin_[tail_ & mask_] > arena_.size()) {
+        ++tail_;
+    }
+}
+
+inline size_t FlightRecorderSink::size() const {
+    std::lock_guard lock(mutex_);
+    return static_cast<size_t>(head_ - tail_);
+}
+
+inline void FlightRecorderSink::dump() {
+    std::lock_guard lock(mutex_);
+    dump_locked();
+}
+
+inline void FlightRecorderSink::dump_locked() {
+    std::ofstream out(dump_path_, std::ios::app | std::ios::binary);
+    if (!out) {
+        return;
+    }
+
+    line_buffer_.clear();
+    std::format_to(std::back_inserter(line_buffer_), "==== Flight recorder dump: {} entries ====\n", head_ - tail_);
+    for (uint64_t i = tail_; i < head_; ++i) {
+        layout_.format(entries_[i & mask_], *this, line_buffer_);
+        line_buffer_ += '\n';
+        if (line_buffer_.size() >= 65536) {
+            out.write(line_buffer_.data(), static_cast<std::streamsize>(line_buffer_.size()));
+            line_buffer_.clear();
+        }
+    }
+    out.write(line_buffer_.data(), static_cast<std::streamsize>(line_buffer_.size()));
+    out.flush();
+    tail_ = head_;
+}
+
+template<typename Inner>
+AsyncSink<Inner>::AsyncSink(std::shared_ptr<Inner> inner, size_t capacity, AsyncOverflow overflow, std::string&& name)
+    : ISink(std::move(name)), inner_(std::move(inner)), overflow_(overflow) {
+    if (!inner_) {
+        throw std::invalid_argument("AsyncSink requires an inner sink");
+    }
+    capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+    slots_.resize(capacity);
+    mask_ = capacity - 1;
+    thread_ = std::thread(&AsyncSink::run, this);
+}
+
+template<typename Inner>
+AsyncSink<Inner>::~AsyncSink() {
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+template<typename Inner>
+void AsyncSink<Inner>::write(const LogEntry& entry) {
+    // Filter for the inner sink here so skipped entries never take a queue slot
+    if (entry.level < inner_->min_level()) {
+        return;
+    }
+
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    while (head - tail_.load(std::memory_order_acquire) > mask_) {
+        if (overflow_ == AsyncOverflow::DROP) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    Slot& slot = slots_[head & mask_];
+    std::memcpy(&slot.entry, &entry, offsetof(LogEntry, args) + entry.arg_count * sizeof(LogArgument));
+
+    // Copy the dynamic strings and bytes, the logger's string queue will be reused
+    size_t total = 0;
+    for (uint8_t i = 0; i < entry.arg_count; ++i) {
+        if (is_queued_data(entry.args[i].type)) {
+            total += entry.args[i].value.dynamic_str.length + 1;
+        }
+    }
+    if (total) {
+        slot.strings.resize(total);
+        char* dest = slot.strings.data();
+        for (uint8_t i = 0; i < entry.arg_count; ++i) {
+            auto& arg = slot.entry.args[i];
+            if (is_queued_data(arg.type)) {
+                std::memcpy(dest, arg.value.dynamic_str.ptr, arg.value.dynamic_str.length);
+                dest[arg.value.dynamic_str.length] = '\0';
+                arg.value.dynamic_str.ptr = dest;
+                dest += arg.value.dynamic_str.length + 1;
+            }
+        }
+    }
+
+    head_.store(head + 1, std::memory_order_release);
+}
+
+template<typename Inner>
+void AsyncSink<Inner>::run() {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    while (true) {
+        // Read running_ before head_ so entries published before shutdown are drained
+        bool running = running_.load(std::memory_order_acquire);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        if (tail == head) {
+            if (!running) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Small delay if no data
+            continue;
+        }
+
+        for (; tail != head; ++tail) {
+            try {
+                inner_->write(slots_[tail & mask_].entry);
+            } catch (...) {
+                // A failing destination must not take down the sink's thread
+            }
+            tail_.store(tail + 1, std::memory_order_release);
+        }
+        try {
+            inner_->flush();
+        } catch (...) {
+        }
+    }
+}
+
+#ifndef _WIN32
+namespace shm_detail {
+
+inline constexpr size_t data_offset = (sizeof(ShmRingHeader) + 127) & ~size_t(127);
+
+inline std::string normalize_name(std::string name) {
+    if (name.empty() || name.front() != '/') {
+        name.insert(name.begin(), '/');
+    }
+    return name;
+}
+
+inline constexpr uint64_t record_size(size_t message_size) noexcept {
+    return (sizeof(ShmRecordHeader) + message_size + 7) & ~uint64_t(7);
+}
+
+} // namespace shm_detail
+
+inline ShmRingSink::ShmRingSink(std::string shm_name, size_t capacity, std::string&& name, bool unlink_on_close)
+    : ISink(std::move(name)), shm_name_(shm_detail::normalize_name(std::move(shm_name))), unlink_on_close_(unlink_on_close) {
+    capacity = std::max<size_t>(capacity, 4096);
+    if (capacity & (capacity - 1)) {
+        capacity = size_t(1) << (64 - std::countl_zero(static_cast<uint64_t>(capacity)));
+    }
+    if (capacity > UINT32_MAX) {
+        throw std::runtime_error("Shared memory ring too large: " + shm_name_);
+    }
+
+    int fd = ::shm_open(shm_name_.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open shared memory: " + shm_name_);
+    }
+    mapped_size_ = shm_detail::data_offset + capacity;
+    if (::ftruncate(fd, static_cast<off_t>(mapped_size_)) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to size shared memory: " + shm_name_);
+    }
+    void* addr = ::mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("Failed to map shared memory: " + shm_name_);
+    }
+
+    header_ = static_cast<ShmRingHeader*>(addr);
+    data_ = static_cast<char*>(addr) + shm_detail::data_offset;
+    mask_ = capacity - 1;
+
+    // Start a new epoch so attached readers restart from the beginning of the fresh ring
+    header_->published_cursor.store(0, std::memory_order_relaxed);
+    header_->reserved_cursor.store(0, std::memory_order_relaxed);
+    header_->magic = ShmRingHeader::MAGIC;
+    header_->version = ShmRingHeader::VERSION;
+    header_->capacity = static_cast<uint32_t>(capacity);
+    header_->epoch.fetch_add(1, std::memory_order_release);
+    message_buffer_.reserve(512);
+}
+
+inline ShmRingSink::~ShmRingSink() {
+    if (header_) {
+        ::munmap(header_, mapped_size_);
+    }
+    if (unlink_on_close_) {
+        ::shm_unlink(shm_name_.c_str());
+    }
+}
+
+inline void ShmRingSink::write(const LogEntry& entry) {
+    message_buffer_.clear();
+    append_thread(entry, message_buffer_);
+    append_context(entry, message_buffer_);
+    bool good = format_log_message(entry, message_buffer_);
+    publish_record(good ? entry.level : LogLevel::L_ERROR, entry.timestamp, message_buffer_);
+}
+
+inline void ShmRingSink::publish_record(LogLevel level, uint64_t timestamp, std::string_view message) {
+    const uint64_t capacity = mask_ + 1;
 
-        // Reopen base file for new day's logs
-        file_stream_.open(base_path_, std::ios::out | std::ios::trunc); // Start fresh for new day
-        if (!file_stream_) {
-            throw std::runtime_error("Failed to reopen daily log file: " + base_path_.string());
-        }
+    // Keep a record well below the ring size so readers always have room to catch up
+    size_t max_message = capacity / 4 - sizeof(ShmRecordHeader);
+    if (message.size() > max_message) {
+        message = message.substr(0, max_message);
+    }
 
-        current_file_size_ = 0;
-        current_date_ = today;
+    uint64_t size = shm_detail::record_size(message.size());
+    uint64_t offset = cursor_ & mask_;
+    uint64_t padding = (offset + size > capacity) ? capacity - offset : 0;
+    uint64_t next = cursor_ + padding + size;
+
+    // Reserve: tell readers this range is about to be overwritten
+    header_->reserved_cursor.store(next, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (padding) {
+        uint32_t wrap = ShmRecordHeader::WRAP;
+        std::memcpy(data_ + offset, &wrap, sizeof(wrap));
+        offset = 0;
     }
+    ShmRecordHeader record{};
+    record.size = static_cast<uint32_t>(message.size());
+    record.level = level;
+    record.timestamp = timestamp;
+    std::memcpy(data_ + offset, &record, sizeof(record));
+    std::memcpy(data_ + offset + sizeof(record), message.data(), message.size());
+
+    // Publish
+    cursor_ = next;
+    header_->published_cursor.store(next, std::memory_order_release);
+}
 
-    // Check for size-based rotation
-    if (config_.max_file_size && current_file_size_ >= config_.max_file_size) {
-        rotate_daily_files();
+inline ShmRingReader::ShmRingReader(std::string shm_name, bool from_oldest)
+    : shm_name_(shm_detail::normalize_name(std::move(shm_name))) {
+    int fd = ::shm_open(shm_name_.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open shared memory: " + shm_name_);
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < shm_detail::data_offset) {
+        ::close(fd);
+        throw std::runtime_error("Shared memory is not a log ring: " + shm_name_);
+    }
+    mapped_size_ = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("Failed to map shared memory: " + shm_name_);
+    }
+
+    header_ = static_cast<const ShmRingHeader*>(addr);
+    data_ = static_cast<const char*>(addr) + shm_detail::data_offset;
+    if (header_->magic != ShmRingHeader::MAGIC || header_->version != ShmRingHeader::VERSION ||
+        shm_detail::data_offset + header_->capacity > mapped_size_) {
+        ::munmap(addr, mapped_size_);
+        throw std::runtime_error("Shared memory is not a log ring: " + shm_name_);
+    }
+    capacity_ = header_->capacity;
+    epoch_ = header_->epoch.load(std::memory_order_acquire);
+
+    uint64_t published = header_->published_cursor.load(std::memory_order_acquire);
+    cursor_ = published;
+    if (from_oldest && published > 0) {
+        // Start of the lap holding the newest record; 0 while the ring has not wrapped
+        cursor_ = (published - 1) & ~(capacity_ - 1);
     }
 }
 
-inline void DailyFileSink::rotate_files_for_date(const std::string& date) {
-    // Remove the oldest file if it exists and max_files is configured
-    // Files are: daily_DATE.log (index 0), daily_DATE_001.log (index 1), ..., daily_DATE_<max_files-1>.log (index max_files-1)
+inline ShmRingReader::~ShmRingReader() {
+    if (header_) {
+        ::munmap(const_cast<ShmRingHeader*>(header_), mapped_size_);
+    }
+}
 
-    auto dated_file = get_dated_filename(date);
+inline void ShmRingReader::resync(uint64_t published) {
+    lost_bytes_ += published - cursor_;
+    cursor_ = published;
+}
 
-    if (config_.max_files == 1) {
-        // If max_files is 1, we only keep the dated file (no indexed files)
-        // Just remove the old dated file - it will be replaced by the new one
-        if (std::filesystem::exists(dated_file)) {
-            std::filesystem::remove(dated_file);
+inline bool ShmRingReader::read(Record& record) {
+    uint64_t epoch = header_->epoch.load(std::memory_order_acquire);
+    if (epoch != epoch_) {
+        // The writer restarted and reinitialized the ring
+        epoch_ = epoch;
+        cursor_ = 0;
+    }
+
+    while (true) {
+        uint64_t published = header_->published_cursor.load(std::memory_order_acquire);
+        if (cursor_ >= published) {
+            return false;
         }
-    } else if (config_.max_files > 1) {
-        // Remove the oldest indexed file
-        auto oldest_file = get_dated_indexed_filename(date, config_.max_files - 1);
-        if (std::filesystem::exists(oldest_file)) {
-            std::filesystem::remove(oldest_file);
+        if (published - cursor_ > capacity_) {
+            resync(published);  // lapped by the writer
+            return false;
         }
 
-        // Rotate existing indexed files for the given date
-        // Start from the highest index and work down to 2
-        for (size_t i = config_.max_files - 1; i >= 2; --i) {
-            auto src = get_dated_indexed_filename(date, i - 1);
-            auto dst = get_dated_indexed_filename(date, i);
+        uint64_t offset = cursor_ & (capacity_ - 1);
+        ShmRecordHeader header;
+        std::memcpy(&header.size, data_ + offset, sizeof(header.size));
+        bool wrap = header.size == ShmRecordHeader::WRAP;
+        if (!wrap && offset + sizeof(header) <= capacity_) {
+            std::memcpy(&header, data_ + offset, sizeof(header));
+        }
+        uint64_t advance = wrap ? capacity_ - offset : shm_detail::record_size(header.size);
+        bool sane = offset + advance <= capacity_;
+        if (sane && !wrap) {
+            record.level = header.level;
+            record.timestamp = header.timestamp;
+            record.message.assign(data_ + offset + sizeof(header), header.size);
+        }
 
-            if (std::filesystem::exists(src)) {
-                std::filesystem::rename(src, dst);
-            }
+        // Validate: the range we copied must not have been reserved for overwriting meanwhile
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t reserved = header_->reserved_cursor.load(std::memory_order_relaxed);
+        if (!sane || reserved - cursor_ > capacity_) {
+            resync(header_->published_cursor.load(std::memory_order_acquire));
+            return false;
         }
 
-        // Rotate the dated file (without index) to _001.log
-        if (std::filesystem::exists(dated_file)) {
-            auto indexed_file_1 = get_dated_indexed_filename(date, 1);
-            std::filesystem::rename(dated_file, indexed_file_1);
+        cursor_ += advance;
+        if (!wrap) {
+            return true;
         }
     }
 }
+#endif
 
-inline void DailyFileSink::rotate_daily_files() {
-    file_stream_.close();
+/**
+ * @brief Pin the calling thread to the CPUs of a NUMA node, as listed in sysfs
+ * @return False if the node is unknown or the affinity could not be set
+ */
+inline bool bind_current_thread_to_numa_node([[maybe_unused]] int node) {
+#ifdef __linux__
+    std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string ranges;
+    if (!std::getline(cpulist, ranges)) {
+        return false;
+    }
+    // e.g. "0-15,32-47"
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    std::istringstream stream(ranges);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        int first = 0;
+        int last = -1;
+        auto [ptr, ec] = std::from_chars(range.data(), range.data() + range.size(), first);
+        if (ec != std::errc()) {
+            continue;
+        }
+        last = first;
+        if (ptr != range.data() + range.size() && *ptr == '-') {
+            std::from_chars(ptr + 1, range.data() + range.size(), last);
+        }
+        for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+            CPU_SET(cpu, &cpus);
+        }
+    }
+    return CPU_COUNT(&cpus) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+    return false;
+#endif
+}
 
-    // Rotate all existing files for the current date (if any)
-    std::filesystem::path dated_file = get_dated_filename(current_date_);
+/**
+ * @brief Back a queue ring with resident memory before logging starts, see LogConfig
+ * Covers the ring's data array only; SlickQueue's slot control array is left as allocated.
+ * The queue allocates and may already have touched the ring, so those pages are 4KB by now.
+ * Huge pages are advised for the whole 2MB extents inside the ring and, where the kernel has
+ * MADV_COLLAPSE (Linux 6.1), collapsed right away; otherwise khugepaged collapses them at
+ * some later point. The NUMA policy only covers the pages entirely inside the ring, so it
+ * does not land on neighbouring heap allocations; pages already touched on another node are
+ * migrated. Prefaulting writes each page back unchanged, split over a few threads for large
+ * rings.
+ * @return Empty, or a description of the first step that failed
+ */
+inline std::string prepare_queue_memory(void* data, size_t bytes, const LogConfig& config) {
+    if (!data || bytes == 0) {
+        return {};
+    }
+    char* begin = static_cast<char*>(data);
+    uintptr_t address = reinterpret_cast<uintptr_t>(begin);
+#ifdef _WIN32
+    const size_t page_size = 4096;
+#else
+    const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+    std::string error;
+
+#if defined(__linux__) && defined(SYS_mbind)
+    if (config.numa_node >= 0) {
+        // Raw syscall rather than libnuma, which would add a link dependency. The values are
+        // MPOL_BIND and MPOL_MF_MOVE from <linux/mempolicy.h>, named so they cannot clash with
+        // its macros when a program includes <numaif.h> first
+        constexpr int mpol_bind = 2;
+        constexpr unsigned mpol_mf_move = 1u << 1;
+        constexpr size_t max_nodes = 1024;
+        unsigned long nodes[max_nodes / (8 * sizeof(unsigned long))] = {};
+        size_t node = static_cast<size_t>(config.numa_node);
+        uintptr_t first = (address + page_size - 1) & ~(uintptr_t(page_size) - 1);
+        uintptr_t last = (address + bytes) & ~(uintptr_t(page_size) - 1);
+        if (node >= max_nodes) {
+            error = "NUMA node " + std::to_string(node) + " out of range";
+        }
+        else if (last > first) {
+            nodes[node / (8 * sizeof(unsigned long))] |= 1ul << (node % (8 * sizeof(unsigned long)));
+            if (syscall(SYS_mbind, first, last - first, mpol_bind, nodes, max_nodes + 1, mpol_mf_move) != 0) {
+                error = std::string("mbind: ") + std::strerror(errno);
+            }
+        }
+    }
+#endif
 
-    // Always rotate if dated file exists, which will shift:
-    // daily_2025-10-02.log -> _001.log
-    // _001.log -> _002.log, etc.
-    if (std::filesystem::exists(dated_file)) {
-        rotate_files_for_date(current_date_);
+#ifdef MADV_HUGEPAGE
+    if (config.huge_pages) {
+        constexpr uintptr_t huge_page_size = uintptr_t(2) << 20;
+        uintptr_t first = (address + huge_page_size - 1) & ~(huge_page_size - 1);
+        uintptr_t last = (address + bytes) & ~(huge_page_size - 1);
+        if (last > first) {
+            ::madvise(reinterpret_cast<void*>(first), last - first, MADV_HUGEPAGE);
+        }
     }
+#endif
 
-    // Rename current base file to dated filename (e.g., daily.log -> daily_2025-10-02.log)
-    std::error_code ec;
-    if (std::filesystem::exists(base_path_)) {
-        std::filesystem::rename(base_path_, dated_file, ec);
-        if (ec) {
-            // If rename fails, try copy and remove
-            std::filesystem::copy_file(base_path_, dated_file, ec);
-            if (!ec) {
-                std::filesystem::remove(base_path_, ec);
+    if (config.prefault_queues) {
+        auto touch = [begin, page_size](size_t from, size_t to) {
+            for (size_t offset = from; offset < to; offset += page_size) {
+                volatile char* byte = begin + offset;
+                *byte = *byte;
             }
+        };
+        constexpr size_t bytes_per_thread = size_t(8) << 20;
+        size_t thread_count = std::min<size_t>({(bytes + bytes_per_thread - 1) / bytes_per_thread,
+                                                std::max(1u, std::thread::hardware_concurrency()), 8});
+        size_t stripe = ((bytes / thread_count) + page_size - 1) & ~(page_size - 1);
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < thread_count; ++i) {
+            threads.emplace_back(touch, i * stripe, std::min(bytes, (i + 1) * stripe));
+        }
+        touch(0, std::min(bytes, stripe));
+        for (auto& thread : threads) {
+            thread.join();
         }
     }
 
-    // Create new current file
-    file_stream_.open(base_path_, std::ios::out | std::ios::trunc);
-    if (!file_stream_) {
-        throw std::runtime_error("Failed to reopen daily log file: " + base_path_.string());
+#if defined(MADV_HUGEPAGE) && defined(MADV_COLLAPSE)
+    if (config.huge_pages) {
+        // The advice only applies to new faults, collapse the pages the queue already touched
+        constexpr uintptr_t huge_page_size = uintptr_t(2) << 20;
+        uintptr_t first = (address + huge_page_size - 1) & ~(huge_page_size - 1);
+        uintptr_t last = (address + bytes) & ~(huge_page_size - 1);
+        if (last > first && ::madvise(reinterpret_cast<void*>(first), last - first, MADV_COLLAPSE) != 0 && error.empty()) {
+            error = std::string("madvise(MADV_COLLAPSE): ") + std::strerror(errno);
+        }
     }
-    current_file_size_ = 0;
+#endif
+
+#ifndef _WIN32
+    if (config.lock_queues) {
+        uintptr_t first = address & ~(uintptr_t(page_size) - 1);
+        if (::mlock(reinterpret_cast<void*>(first), address + bytes - first) != 0 && error.empty()) {
+            error = std::string("mlock: ") + std::strerror(errno);
+        }
+    }
+#endif
+    return error;
 }
 
-inline std::filesystem::path DailyFileSink::get_daily_filename() const {
-    std::string date_str = get_date_string();
-    return get_dated_filename(date_str);
+inline Logger& Logger::instance() {
+    static Logger instance;
+    return instance;
 }
 
-inline std::filesystem::path DailyFileSink::get_dated_filename(const std::string& date) const {
-    std::string filename = base_path_.stem().string() + "_" + date + base_path_.extension().string();
-    return base_path_.parent_path() / filename;
+inline void Logger::init(const std::filesystem::path& log_file, size_t log_queue_size, size_t string_buffer_size) {
+    shutdown(); // make sure the logger is stopped
+    add_sink(std::make_shared<FileSink>(log_file));
+    create_queues(log_queue_size, string_buffer_size);
+    log_file_ = log_file;
+    start();
 }
 
-inline std::filesystem::path DailyFileSink::get_dated_indexed_filename(const std::string& date, size_t index) const {
-    std::ostringstream oss;
-    oss << base_path_.stem().string() << "_" << date << "_" << std::setfill('0') << std::setw(3) << index << base_path_.extension().string();
-    return base_path_.parent_path() / oss.str();
+inline Category& Logger::category(std::string_view name) {
+    std::lock_guard lock(category_mutex_);
+    auto iter = categories_.find(std::string(name));
+    if (iter != categories_.end()) {
+        return *iter->second;
+    }
+    auto category = std::make_unique<Category>(*this, std::string(name));
+    category->set_level(resolve_category_level(name));
+    return *categories_.emplace(category->name(), std::move(category)).first->second;
 }
 
-inline std::string DailyFileSink::get_date_string() const {
-    auto now = std::chrono::system_clock::now();
-    time_t time_val = std::chrono::system_clock::to_time_t(now);
-    std::tm* tm_ptr = std::localtime(&time_val);
-    if (!tm_ptr) {
-        return "1970-01-01"; // fallback date
+inline void Logger::set_category_levels(std::string_view rules) {
+    std::unordered_map<std::string, LogLevel> parsed;
+    auto trim = [](std::string_view str) {
+        size_t begin = str.find_first_not_of(" \t\r");
+        size_t end = str.find_last_not_of(" \t\r");
+        return begin == std::string_view::npos ? std::string_view() : str.substr(begin, end - begin + 1);
+    };
+
+    size_t pos = 0;
+    while (pos <= rules.size()) {
+        size_t end = rules.find_first_of(",;\n", pos);
+        if (end == std::string_view::npos) {
+            end = rules.size();
+        }
+        std::string_view rule = trim(rules.substr(pos, end - pos));
+        pos = end + 1;
+        if (rule.empty()) {
+            continue;
+        }
+
+        size_t eq = rule.find('=');
+        std::string_view pattern = eq == std::string_view::npos ? std::string_view() : trim(rule.substr(0, eq));
+        auto level = eq == std::string_view::npos ? std::nullopt : level_from_string(trim(rule.substr(eq + 1)));
+        if (pattern.empty() || !level) {
+            throw std::runtime_error("Invalid category rule: " + std::string(rule));
+        }
+        parsed[std::string(pattern)] = *level;
     }
-    std::tm tm = *tm_ptr;
 
-    char date_str[11];
-    std::strftime(date_str, sizeof(date_str), "%Y-%m-%d", &tm);
-    return std::string(date_str);
+    std::lock_guard lock(category_mutex_);
+    category_rules_ = std::move(parsed);
+    for (auto& [name, category] : categories_) {
+        category->set_level(resolve_category_level(name));
+    }
 }
 
-inline Logger& Logger::instance() {
-    static Logger instance;
-    return instance;
+inline LogLevel Logger::resolve_category_level(std::string_view name) const {
+    // Called with category_mutex_ held. Exact rule first, then `prefix.*` from the longest prefix
+    auto find = [this](std::string_view pattern) -> const LogLevel* {
+        auto iter = category_rules_.find(std::string(pattern));
+        return iter != category_rules_.end() ? &iter->second : nullptr;
+    };
+    if (auto level = find(name)) {
+        return *level;
+    }
+    std::string_view prefix = name;
+    while (!prefix.empty()) {
+        if (auto level = find(std::string(prefix) + ".*")) {
+            return *level;
+        }
+        size_t dot = prefix.rfind('.');
+        prefix = dot == std::string_view::npos ? std::string_view() : prefix.substr(0, dot);
+    }
+    if (auto level = find("*")) {
+        return *level;
+    }
+    return LogLevel::L_TRACE;
 }
 
-inline void Logger::init(const std::filesystem::path& log_file, size_t log_queue_size, size_t string_buffer_size) {
-    shutdown(); // make sure the logger is stopped
-    add_sink(std::make_shared<FileSink>(log_file));
-    
+inline void Logger::create_queues(size_t log_queue_size, size_t string_buffer_size) {
     // Ensure queue_size is power of 2
     log_queue_size = round_up_to_power_of_2(log_queue_size);
     string_buffer_size = round_up_to_power_of_2(string_buffer_size);
 
-    log_queue_ = std::make_unique<slick::SlickQueue<LogEntry>>(static_cast<uint32_t>(log_queue_size));
-    string_queue_ = std::make_unique<slick::SlickQueue<char>>(static_cast<uint32_t>(string_buffer_size));
-    log_file_ = log_file;
-    start();
+    // Queues kept by shutdown() are reused; the writer starts reading after their last entry
+    if (!log_queue_ || log_queue_->size() != log_queue_size) {
+        log_queue_ = std::make_unique<slick::SlickQueue<LogEntry>>(static_cast<uint32_t>(log_queue_size));
+    }
+    if (!string_queue_ || string_queue_->size() != string_buffer_size) {
+        string_queue_ = std::make_unique<slick::SlickQueue<char>>(static_cast<uint32_t>(string_buffer_size));
+    }
 }
 
-inline void Logger::start() {
+inline bool Logger::start(int numa_node) {
     running_ = true;
+    writer_ready_.store(false, std::memory_order_relaxed);
     
     // Initialize read_index_ before starting the thread
     read_index_ = log_queue_->initial_reading_index();
     
-    writer_thread_ = std::thread([this]() { writer_thread_func(); });
+    // The writer pins itself before its first read; bound is published by writer_ready_
+    bool bound = true;
+    writer_thread_ = std::thread([this, numa_node, &bound]() {
+        if (numa_node >= 0) {
+            bound = bind_current_thread_to_numa_node(numa_node);
+        }
+        writer_thread_func();
+    });
+    writer_ready_.wait(false, std::memory_order_acquire);
+    gate_.word.fetch_and(~GATE_CLOSED, std::memory_order_release);
     
-    // Give a small delay to ensure writer thread is started
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    log(LogLevel::L_INFO, "SlickLogger v{}", SLICK_LOGGER_VERSION);
+    if (version_banner_) {
+        log(LogLevel::L_INFO, "SlickLogger v{}", SLICK_LOGGER_VERSION);
+    }
+    return bound;
 }
 
 inline void Logger::init(const LogConfig& config) {
@@ -1271,32 +4565,185 @@ inline void Logger::init(const LogConfig& config) {
     }
     
     set_level(config.min_level);
-    
-    // Ensure queue_size is power of 2
-    size_t log_queue_size = round_up_to_power_of_2(config.log_queue_size);
-    size_t string_buffer_size = round_up_to_power_of_2(config.string_buffer_size);
+    if (!config.category_levels.empty()) {
+        set_category_levels(config.category_levels);
+    }
+    set_version_banner(config.version_banner);
+
+    create_queues(config.log_queue_size, config.string_buffer_size);
+    std::string memory_error = prepare_queue_memory((*log_queue_)[0], log_queue_->size() * sizeof(LogEntry), config);
+    std::string string_memory_error = prepare_queue_memory((*string_queue_)[0], string_queue_->size(), config);
+    bool bound = start(config.numa_node);
+    if (!memory_error.empty() || !string_memory_error.empty()) {
+        log(LogLevel::L_WARN, "Failed to prepare queue memory: {}", memory_error.empty() ? string_memory_error : memory_error);
+    }
+    if (!bound) {
+        log(LogLevel::L_WARN, "Failed to bind the writer thread to NUMA node {}", config.numa_node);
+    }
+}
 
-    log_queue_ = std::make_unique<slick::SlickQueue<LogEntry>>(static_cast<uint32_t>(log_queue_size));
-    string_queue_ = std::make_unique<slick::SlickQueue<char>>(static_cast<uint32_t>(string_buffer_size));
-    start();
+inline void Logger::SinkTable::rebuild_routes() noexcept {
+    broadcast_routes.fill(0);
+    level_routes.fill(0);
+    for (size_t i = 0; i < sinks.size(); ++i) {
+        const auto& sink = sinks[i];
+        if (!sink) {
+            continue;
+        }
+        uint64_t bit = uint64_t(1) << i;
+        for (size_t level = static_cast<size_t>(sink->min_level()); level < LEVEL_COUNT; ++level) {
+            level_routes[level] |= bit;
+            if (!sink->is_dedicated()) {
+                broadcast_routes[level] |= bit;
+            }
+        }
+    }
+}
+
+template<typename F>
+inline uint64_t Logger::update_sinks(F&& update) {
+    std::lock_guard lock(sink_mutex_);
+    auto table = std::make_unique<SinkTable>(*sink_table_.load(std::memory_order_relaxed));
+    update(*table);
+    table->rebuild_routes();
+    retired_tables_.reserve(retired_tables_.size() + 1);    // nothing below throws once the table is published
+
+    SinkTable* old_table = sink_table_.exchange(table.release(), std::memory_order_seq_cst);
+    uint64_t epoch = global_epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+    retire_sink_table(old_table, epoch);
+    return epoch;
+}
+
+inline void Logger::wait_for_writer(uint64_t epoch) const {
+    // Grace period: wait until the writer thread no longer uses a table older than epoch
+    if (std::this_thread::get_id() == writer_thread_.get_id()) {
+        return;
+    }
+    while (true) {
+        uint64_t writer_epoch = writer_epoch_.load(std::memory_order_seq_cst);
+        if (writer_epoch == IDLE_EPOCH || writer_epoch >= epoch) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+inline void Logger::retire_sink_table(SinkTable* table, uint64_t epoch) {
+    retired_tables_.emplace_back(table, epoch);
+    has_retired_.store(true, std::memory_order_release);
+    reclaim_sink_tables();
+}
+
+inline void Logger::reclaim_sink_tables() {
+    // Called with sink_mutex_ held
+    uint64_t writer_epoch = writer_epoch_.load(std::memory_order_seq_cst);
+    auto safe = [writer_epoch](const auto& retired) {
+        if (writer_epoch == IDLE_EPOCH || writer_epoch >= retired.second) {
+            delete retired.first;
+            return true;
+        }
+        return false;
+    };
+    retired_tables_.erase(std::remove_if(retired_tables_.begin(), retired_tables_.end(), safe), retired_tables_.end());
+    has_retired_.store(!retired_tables_.empty(), std::memory_order_release);
+}
+
+inline void Logger::refresh_routes() {
+    update_sinks([](SinkTable&) {});
 }
 
 inline void Logger::add_sink(std::shared_ptr<ISink> sink) {
-    sink->set_index(static_cast<int>(sinks_.size()));
-    sinks_.push_back(sink);
-    if (!sink->name().empty()) {
-        sinkname_index_map_[sink->name()] = sink->index();
+    if (sink->logger_ && sink->logger_ != this) {
+        throw std::runtime_error("Sink is already added to another logger");
+    }
+    update_sinks([this, &sink](SinkTable& table) {
+        // Append while bits are left, so bits of removed sinks are not reused while
+        // targeted entries for them may still be queued
+        size_t index = table.sinks.size();
+        if (index >= SLICK_LOGGER_MAX_SINKS) {
+            index = std::find(table.sinks.begin(), table.sinks.end(), nullptr) - table.sinks.begin();
+            if (index >= SLICK_LOGGER_MAX_SINKS) {
+                throw std::runtime_error("Too many sinks, at most " + std::to_string(SLICK_LOGGER_MAX_SINKS) + " are supported");
+            }
+        } else {
+            table.sinks.emplace_back();
+        }
+        sink->set_index(static_cast<int>(index));
+        sink->logger_ = this;
+        table.sinks[index] = sink;
+        ++table.sink_count;
+        if (!sink->name().empty()) {
+            table.name_index[sink->name()] = sink->index();
+        }
+    });
+}
+
+inline bool Logger::remove_sink(const std::shared_ptr<ISink>& sink) {
+    if (!sink) {
+        return false;
+    }
+    bool removed = false;
+    uint64_t epoch = update_sinks([&](SinkTable& table) {
+        int index = sink->index();
+        if (index < 0 || static_cast<size_t>(index) >= table.sinks.size() || table.sinks[index] != sink) {
+            return;
+        }
+        if (!sink->name().empty()) {
+            table.name_index.erase(sink->name());
+        }
+        table.sinks[index].reset();
+        --table.sink_count;
+        removed = true;
+    });
+    if (removed) {
+        wait_for_writer(epoch);
+        sink->set_index(-1);
+        sink->logger_ = nullptr;
     }
+    return removed;
+}
+
+inline bool Logger::remove_sink(std::string_view name) {
+    auto sink = get_sink(name);
+    return sink ? remove_sink(sink) : false;
 }
 
 inline void Logger::clear_sinks() {
-    sinks_.clear();
-    sinkname_index_map_.clear();
+    std::vector<std::shared_ptr<ISink>> removed;
+    uint64_t epoch = update_sinks([&removed](SinkTable& table) {
+        // Keep the slots, like remove_sink, so bits of queued targeted entries are not reused
+        for (auto& sink : table.sinks) {
+            if (sink) {
+                removed.push_back(std::move(sink));
+            }
+        }
+        table.name_index.clear();
+        table.sink_count = 0;
+    });
+    wait_for_writer(epoch);
+    for (auto& sink : removed) {
+        sink->set_index(-1);
+        sink->logger_ = nullptr;
+    }
+}
+
+inline uint64_t Logger::sink_mask(std::initializer_list<std::string_view> names) const noexcept {
+    std::lock_guard lock(sink_mutex_);
+    const SinkTable* table = sink_table_.load(std::memory_order_relaxed);
+    uint64_t mask = 0;
+    for (auto name : names) {
+        auto iter = table->name_index.find(name);
+        if (iter != table->name_index.end()) {
+            mask |= uint64_t(1) << iter->second;
+        }
+    }
+    return mask;
 }
 
 template<typename SinkT>
 inline std::shared_ptr<ISink> Logger::get_sink() const noexcept {
-    for (auto &sink : sinks_) {
+    std::lock_guard lock(sink_mutex_);
+    for (auto &sink : sink_table_.load(std::memory_order_relaxed)->sinks) {
         if (dynamic_cast<SinkT*>(sink.get()) != nullptr) {
             return sink;
         }
@@ -1305,11 +4752,13 @@ inline std::shared_ptr<ISink> Logger::get_sink() const noexcept {
 }
 
 inline std::shared_ptr<ISink> Logger::get_sink(std::string_view name) const noexcept {
-    auto iter = sinkname_index_map_.find(name);
-    if (iter != sinkname_index_map_.end()) {
+    std::lock_guard lock(sink_mutex_);
+    const SinkTable* table = sink_table_.load(std::memory_order_relaxed);
+    auto iter = table->name_index.find(name);
+    if (iter != table->name_index.end()) {
         int index = iter->second;
-        if (index >= 0 && static_cast<size_t>(index) < sinks_.size()) [[likely]] {
-            return sinks_[index];
+        if (index >= 0 && static_cast<size_t>(index) < table->sinks.size()) [[likely]] {
+            return table->sinks[index];
         }
     }
     return nullptr;  
@@ -1318,17 +4767,12 @@ inline std::shared_ptr<ISink> Logger::get_sink(std::string_view name) const noex
 inline void Logger::init(size_t queue_size, size_t string_buffer_size) {
     shutdown(false); // make sure the logger is stopped
 
-    if (sinks_.empty()) {
+    if (sink_table_.load(std::memory_order_acquire)->sink_count == 0) {
         throw std::runtime_error("No sink. Sinks should be added first before calling this.");
     }
 
     // Initialize logger with pre-set sinks - sinks should be added before calling this
-    // Ensure queue_size is power of 2
-    queue_size = round_up_to_power_of_2(queue_size);
-    string_buffer_size = round_up_to_power_of_2(string_buffer_size);
-
-    log_queue_ = std::make_unique<slick::SlickQueue<LogEntry>>(static_cast<uint32_t>(queue_size));
-    string_queue_ = std::make_unique<slick::SlickQueue<char>>(static_cast<uint32_t>(string_buffer_size));
+    create_queues(queue_size, string_buffer_size);
     start();
 }
 
@@ -1380,6 +4824,20 @@ inline void Logger::add_daily_file_sink(const std::filesystem::path& path, const
     add_sink(std::make_shared<DailyFileSink>(path, config, custom_timestamp_format, std::move(name)));
 }
 
+inline void Logger::add_json_lines_sink(const std::filesystem::path& path, std::string&& name) {
+    add_sink(std::make_shared<JsonLinesSink>(path, std::move(name)));
+}
+
+inline void Logger::add_flight_recorder_sink(const std::filesystem::path& dump_path, size_t capacity, std::string&& name) {
+    add_sink(std::make_shared<FlightRecorderSink>(dump_path, capacity, 1024 * 1024, std::move(name)));
+}
+
+#ifndef _WIN32
+inline void Logger::add_shm_ring_sink(const std::string& shm_name, size_t capacity, std::string&& name) {
+    add_sink(std::make_shared<ShmRingSink>(shm_name, capacity, std::move(name)));
+}
+#endif
+
 // Helper function to convert arguments to owned types
 template<typename T>
 constexpr auto make_owned_arg(T&& arg) {
@@ -1401,7 +4859,7 @@ constexpr auto make_owned_arg(T&& arg) {
 
 template<typename FormatT, typename... Args>
 inline void Logger::log(LogLevel level, FormatT&& format, Args&&... args) {
-    log_to_sink(-1, level, std::forward<FormatT>(format), std::forward<Args>(args)...);
+    log_to_sinks(0, level, std::forward<FormatT>(format), std::forward<Args>(args)...);
 }
 
 // #define IS_STRING_LITERAL(x) ([&]<class T = char>() { \
@@ -1413,26 +4871,51 @@ inline void Logger::log(LogLevel level, FormatT&& format, Args&&... args) {
 
 template<typename FormatT, typename... Args>
 inline void Logger::log_to_sink(int sink_index, LogLevel level, FormatT&& format, Args&&... args) {
-    if (!running_.load(std::memory_order_relaxed) || !log_queue_ || level < log_level_.load(std::memory_order_relaxed))
-    {
+    uint64_t sink_mask = (sink_index >= 0 && sink_index < SLICK_LOGGER_MAX_SINKS) ? uint64_t(1) << sink_index : 0;
+    log_to_sinks(sink_mask, level, std::forward<FormatT>(format), std::forward<Args>(args)...);
+}
+
+template<typename FormatT, typename... Args>
+inline void Logger::log_to_sinks(uint64_t sink_mask, LogLevel level, FormatT&& format, Args&&... args) {
+    if (static_cast<uint32_t>(level) < gate_.word.load(std::memory_order_relaxed)) {
         return;
     }
 
+    uint64_t index = log_queue_->reserve();
+    fill_entry(*(*log_queue_)[index], sink_mask, level, std::forward<FormatT>(format), std::forward<Args>(args)...);
+    log_queue_->publish(index);
+}
+
+template<typename FormatT, typename... Args>
+inline void Logger::log_category(uint64_t sink_mask, LogLevel level, FormatT&& format, Args&&... args) {
+    if (gate_.word.load(std::memory_order_relaxed) & GATE_CLOSED) {
+        return;
+    }
+
+    uint64_t index = log_queue_->reserve();
+    fill_entry(*(*log_queue_)[index], sink_mask, level, std::forward<FormatT>(format), std::forward<Args>(args)...);
+    log_queue_->publish(index);
+}
+
+template<typename FormatT, typename... Args>
+inline void Logger::fill_entry(LogEntry& entry, uint64_t sink_mask, LogLevel level, FormatT&& format, Args&&... args) {
     auto now = std::chrono::system_clock::now();
     auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
 
-    LogEntry entry;
     entry.level = level;
     entry.timestamp = ns;
-    entry.sink_index = sink_index;
+    entry.sink_mask = sink_mask;
+    entry.context_id = detail::current_context_id;
+    entry.thread_id = current_thread_id();
     if constexpr (IS_STRING_LITERAL(format)) {
         entry.format_ptr = format;  // String literal - safe to store pointer
-        entry.arg_count = sizeof...(args);
+        constexpr size_t slot_count = (size_t(0) + ... + argument_slots_v<Args>);
+        static_assert(slot_count <= SLICK_LOGGER_MAX_ARGS, "Too many log arguments");
+        entry.arg_count = static_cast<uint8_t>(slot_count);
 
-        // push arguments
+        // push arguments, named arguments take two slots
         size_t arg_idx = 0;
-        static_assert(sizeof...(args) <= SLICK_LOGGER_MAX_ARGS, "Too many log arguments");
-        (enqueue_argument(entry.args[arg_idx++], std::forward<Args>(args)), ...);
+        ((enqueue_argument(entry.args[arg_idx], std::forward<Args>(args)), arg_idx += argument_slots_v<Args>), ...);
     } 
     else {
         // Store dynamic string in string queue
@@ -1441,19 +4924,80 @@ inline void Logger::log_to_sink(int sink_index, LogLevel level, FormatT&& format
         entry.arg_count = 1;
         enqueue_argument(entry.args[0], format);
     }
+}
 
+inline LogBatch Logger::batch(uint32_t n) {
+    if (gate_.word.load(std::memory_order_relaxed) & GATE_CLOSED) {
+        return LogBatch(nullptr, 0, 0);
+    }
+    if (n == 0) {
+        return LogBatch(nullptr, 0, 0);
+    }
+    if (n > log_queue_->size()) {
+        throw std::runtime_error("Batch of " + std::to_string(n) + " entries exceeds the log queue size");
+    }
+    return LogBatch(this, log_queue_->reserve(n), n);
+}
 
+template<typename FormatT, typename... Args>
+inline void LogBatch::log(LogLevel level, FormatT&& format, Args&&... args) {
+    if (!logger_ || used_ == capacity_) [[unlikely]] {
+        if (logger_) {
+            // Reserved entries used up: the index still orders this line after the batch
+            logger_->log(level, std::forward<FormatT>(format), std::forward<Args>(args)...);
+        }
+        return;
+    }
+    if (static_cast<uint32_t>(level) < logger_->gate_.word.load(std::memory_order_relaxed)) {
+        return;
+    }
+    logger_->fill_entry(*(*logger_->log_queue_)[start_ + used_], 0, level, std::forward<FormatT>(format), std::forward<Args>(args)...);
+    ++used_;
+}
 
-    uint64_t index = log_queue_->reserve();
-    *(*log_queue_)[index] = std::move(entry);
-    log_queue_->publish(index);
+inline void LogBatch::publish() noexcept {
+    if (!logger_) {
+        return;
+    }
+    // The writer reads whole reservations, so unused slots are published as empty entries
+    for (uint32_t i = used_; i < capacity_; ++i) {
+        LogEntry& entry = *(*logger_->log_queue_)[start_ + i];
+        entry.format_ptr = nullptr;
+        entry.arg_count = 0;
+    }
+    logger_->log_queue_->publish(start_, capacity_);
+    logger_ = nullptr;
 }
 
 template<typename T>
 inline void Logger::enqueue_argument(LogArgument& arg, T&& value) {
     using DecayedT = std::decay_t<T>;
 
-    if constexpr (std::is_same_v<DecayedT, bool>) {
+    if constexpr (is_key_value<std::remove_cvref_t<T>>::value) {
+        // Key pointer in this slot, the value in the next one
+        arg.type = ArgType::KEY;
+        arg.value.literal_ptr = value.key;
+        enqueue_argument((&arg)[1], std::forward<decltype(value.value)>(value.value));
+    }
+    else if constexpr (ArrayArgument<std::remove_cvref_t<T>>) {
+        // Contiguous range of numbers - element type tag plus one memcpy into the string queue
+        using ElementT = std::remove_cv_t<std::ranges::range_value_t<std::remove_cvref_t<T>>>;
+        // Elements beyond the string queue's capacity are dropped and the argument marked
+        size_t count = std::ranges::size(value);
+        size_t max_count = (string_queue_->size() - 1) / sizeof(ElementT);
+        bool truncated = count > max_count;
+        size_t size = 1 + std::min(count, max_count) * sizeof(ElementT);
+        uint64_t start_index = string_queue_->reserve(static_cast<uint32_t>(size));
+        char* dest = (*string_queue_)[start_index];
+        dest[0] = static_cast<char>(array_element_type<ElementT>());
+        if (size > 1) {
+            std::memcpy(dest + 1, std::ranges::data(value), size - 1);
+        }
+        string_queue_->publish(start_index, static_cast<uint32_t>(size));
+        arg.type = ArgType::ARRAY;
+        arg.value.dynamic_str = StringRef{dest, static_cast<uint32_t>(size), truncated};
+    }
+    else if constexpr (std::is_same_v<DecayedT, bool>) {
         arg.type = ArgType::BOOL;
         arg.value.b = value;
     }
@@ -1547,6 +5091,22 @@ inline void Logger::enqueue_argument(LogArgument& arg, T&& value) {
         arg.type = ArgType::STRING_DYNAMIC;
         arg.value.dynamic_str = store_string_in_queue(value);
     }
+    else if constexpr (std::is_same_v<DecayedT, Decimal>) {
+        arg.type = ArgType::DECIMAL;
+        arg.value.decimal = value;
+    }
+    else if constexpr (std::is_same_v<DecayedT, Bytes>) {
+        // Raw bytes - one memcpy into the string queue, rendered by the writer thread
+        arg.type = ArgType::BYTES;
+        arg.value.dynamic_str = store_string_in_queue(std::string_view(static_cast<const char*>(value.data), value.size));
+    }
+    else if constexpr (std::is_same_v<DecayedT, PersistentString>) {
+        // Outlives the logger - store pointer and length only
+        arg.type = ArgType::STRING_PERSISTENT;
+        constexpr size_t max_length = (size_t(1) << 31) - 1;
+        bool truncated = value.value.size() > max_length;
+        arg.value.dynamic_str = StringRef{value.value.data(), static_cast<uint32_t>(truncated ? max_length : value.value.size()), truncated};
+    }
     else if constexpr (std::is_same_v<DecayedT, std::string>) {
         // Dynamic string - copy to string queue
         arg.type = ArgType::STRING_DYNAMIC;
@@ -1569,21 +5129,26 @@ inline void Logger::enqueue_argument(LogArgument& arg, T&& value) {
 }
 
 inline StringRef Logger::store_string_in_queue(std::string_view str) {
-    uint32_t length = str.length();
+    // Longer data would overrun the string queue: keep the head and mark the argument
+    size_t capacity = string_queue_->size() - 1;
+    bool truncated = str.length() > capacity;
+    uint32_t length = static_cast<uint32_t>(truncated ? capacity : str.length());
     auto len = length + 1; // +1 for null terminator
 
     // Reserve space in string queue
     uint64_t start_index = string_queue_->reserve(len);
-    // Copy string data
+    // Copy string data, string_view and binary data need not be null terminated
     char* dest = (*string_queue_)[start_index];
-    std::memcpy(dest, str.data(), len);
+    std::memcpy(dest, str.data(), length);
+    dest[length] = '\0';
 
     // Publish the string data
     string_queue_->publish(start_index, len);
-    return StringRef{dest, length};
+    return StringRef{dest, length, truncated};
 }
 
 inline void Logger::shutdown(bool clear_sinks) {
+    gate_.word.fetch_or(GATE_CLOSED, std::memory_order_release);
     if (running_.load(std::memory_order_relaxed)) {
         running_.store(false, std::memory_order_release);
         if (writer_thread_.joinable()) {
@@ -1593,25 +5158,34 @@ inline void Logger::shutdown(bool clear_sinks) {
     
     if (clear_sinks) {
         // Clear sinks to release file handles and other resources
-        sinks_.clear();
+        Logger::clear_sinks();
     }
-    log_queue_.reset();
-    string_queue_.reset();
 }
 
 inline Logger::~Logger() {
     shutdown();
+    std::lock_guard lock(sink_mutex_);
+    reclaim_sink_tables();
+    delete sink_table_.exchange(nullptr);
 }
 
 inline void Logger::reset() {
     shutdown();
     // Reset all state for fresh initialization
+    log_queue_.reset();
+    string_queue_.reset();
+    // No queued entry targets a sink bit any more, so the bits can be handed out again
+    update_sinks([](SinkTable& table) { table = SinkTable{}; });
     log_file_.clear();
     read_index_ = 0;
-    log_level_.store(LogLevel::L_TRACE);
+    version_banner_ = true;
+    set_level(LogLevel::L_TRACE);
 }
 
 inline void Logger::writer_thread_func() {
+    writer_ready_.store(true, std::memory_order_release);
+    writer_ready_.notify_one();
+
     while (running_.load(std::memory_order_relaxed)) {
         auto [entry_ptr, count] = log_queue_->read(read_index_);
         if (entry_ptr) {
@@ -1632,33 +5206,38 @@ inline void Logger::writer_thread_func() {
 }
 
 inline void Logger::write_log_entry(const LogEntry* entry_ptr, uint32_t count) {
+    // Enter the current epoch before loading the table, so it is not reclaimed under us
+    writer_epoch_.store(global_epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    const SinkTable& table = *sink_table_.load(std::memory_order_seq_cst);
+
     for (uint32_t i = 0; i < count; ++i) {
         const LogEntry& entry = entry_ptr[i];
-        if (entry.sink_index >= 0 && static_cast<size_t>(entry.sink_index) < sinks_.size()) {
-            // Write to specific sink
-            auto &sink = sinks_[entry.sink_index];
-            if (entry.level < sink->min_level()) {
-                continue; // Skip if log level is below sink's minimum level
-            }
-            sink->write(entry);
+        if (!entry.format_ptr) [[unlikely]] {
+            continue;   // unused LogBatch slot
         }
-        else {
-            // Write to all non-dedicated sinks
-            for (auto& sink : sinks_) {
-                if (entry.level < sink->min_level() || sink->is_dedicated()) {
-                    continue; // Skip if log level is below sink's minimum level or sink is dedicated
-                }
-                sink->write(entry);
-            }
+        size_t level = std::min(static_cast<size_t>(entry.level), LEVEL_COUNT - 1);
+        // Targeted entries go to the requested sinks, others to all non-dedicated sinks,
+        // in both cases only to sinks whose minimum level accepts the entry
+        uint64_t routes = entry.sink_mask ? (entry.sink_mask & table.level_routes[level]) : table.broadcast_routes[level];
+        while (routes) {
+            table.sinks[std::countr_zero(routes)]->write(entry);
+            routes &= routes - 1;
         }
     }
     
     // Flush all sinks
-    for (auto& sink : sinks_) {
+    for (auto& sink : table.sinks) {
         if (sink) {
             sink->flush();
         }
     }
+
+    writer_epoch_.store(IDLE_EPOCH, std::memory_order_seq_cst);
+    if (has_retired_.load(std::memory_order_acquire)) {
+        // Free tables replaced during this batch, off the producers' path
+        std::lock_guard lock(sink_mutex_);
+        reclaim_sink_tables();
+    }
 }
 
 inline size_t Logger::round_up_to_power_of_2(size_t value) noexcept {
@@ -1691,3 +5270,11 @@ inline size_t Logger::round_up_to_power_of_2(size_t value) noexcept {
 #define LOG_WARN(...) slick::logger::Logger::instance().log(slick::logger::LogLevel::L_WARN, __VA_ARGS__)
 #define LOG_ERROR(...) slick::logger::Logger::instance().log(slick::logger::LogLevel::L_ERROR, __VA_ARGS__)
 #define LOG_FATAL(...) slick::logger::Logger::instance().log(slick::logger::LogLevel::L_FATAL, __VA_ARGS__)
+
+// Category macros, category is a slick::logger::Category&
+#define LOG_CAT_TRACE(category, ...) (category).log(slick::logger::LogLevel::L_TRACE, __VA_ARGS__)
+#define LOG_CAT_DEBUG(category, ...) (category).log(slick::logger::LogLevel::L_DEBUG, __VA_ARGS__)
+#define LOG_CAT_INFO(category, ...) (category).log(slick::logger::LogLevel::L_INFO, __VA_ARGS__)
+#define LOG_CAT_WARN(category, ...) (category).log(slick::logger::LogLevel::L_WARN, __VA_ARGS__)
+#define LOG_CAT_ERROR(category, ...) (category).log(slick::logger::LogLevel::L_ERROR, __VA_ARGS__)
+#define LOG_CAT_FATAL(category, ...) (category).log(slick::logger::LogLevel::L_FATAL, __VA_ARGS__)
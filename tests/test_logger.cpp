@@ -4,6 +4,9 @@
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <array>
+#include <span>
 
 class SlickLoggerTest : public ::testing::Test {
 protected:
@@ -347,6 +350,454 @@ TEST_F(SlickLoggerTest, CharArrayLogging) {
     EXPECT_TRUE(file_contents.find("Log char array: test char array") != std::string::npos);
 }
 
+TEST_F(SlickLoggerTest, CategoryLevels) {
+    using slick::logger::LogLevel;
+    auto& logger = slick::logger::Logger::instance();
+
+    EXPECT_EQ(slick::logger::level_from_string("debug"), LogLevel::L_DEBUG);
+    EXPECT_EQ(slick::logger::level_from_string("Warning"), LogLevel::L_WARN);
+    EXPECT_FALSE(slick::logger::level_from_string("LOUD").has_value());
+    EXPECT_THROW(logger.set_category_levels("fix.*"), std::runtime_error);
+    EXPECT_THROW(logger.set_category_levels("fix.*=LOUD"), std::runtime_error);
+
+    auto& session = logger.category("fix.session");
+    EXPECT_EQ(&session, &logger.category("fix.session"));   // handles are stable
+
+    logger.set_category_levels("fix.*=DEBUG; fix.session=TRACE, *=WARN");
+    auto& order = logger.category("fix.order");
+    auto& fix = logger.category("fix");
+    auto& book = logger.category("md.book");
+    EXPECT_EQ(session.level(), LogLevel::L_TRACE);
+    EXPECT_EQ(order.level(), LogLevel::L_DEBUG);
+    EXPECT_EQ(fix.level(), LogLevel::L_DEBUG);
+    EXPECT_EQ(book.level(), LogLevel::L_WARN);
+
+    std::filesystem::remove("test.log");
+    logger.init("test.log", 1024);
+    logger.set_level(LogLevel::L_INFO);     // category levels apply regardless of the global level
+    LOG_TRACE("global trace");
+    LOG_DEBUG("global debug");
+    LOG_CAT_TRACE(session, "session trace {}", 1);
+    LOG_CAT_TRACE(order, "order trace");
+    LOG_CAT_DEBUG(order, "order debug {}", 2);
+    LOG_CAT_INFO(book, "book info");
+    LOG_CAT_WARN(book, "book warn");
+    logger.shutdown();
+
+    // A config without rules keeps the current ones
+    slick::logger::LogConfig config;
+    config.sinks.push_back(std::make_shared<slick::logger::FileSink>("test.log"));
+    logger.init(config);
+    logger.shutdown();
+    EXPECT_EQ(book.level(), LogLevel::L_WARN);
+
+    // Changing the rules updates existing categories
+    logger.set_category_levels("");
+    EXPECT_EQ(book.level(), LogLevel::L_TRACE);
+
+    std::ifstream log_file("test.log");
+    std::string contents((std::istreambuf_iterator<char>(log_file)), std::istreambuf_iterator<char>());
+    EXPECT_TRUE(contents.find("global trace") == std::string::npos);
+    EXPECT_TRUE(contents.find("global debug") == std::string::npos);
+    EXPECT_TRUE(contents.find("session trace 1") != std::string::npos);
+    EXPECT_TRUE(contents.find("order trace") == std::string::npos);
+    EXPECT_TRUE(contents.find("order debug 2") != std::string::npos);
+    EXPECT_TRUE(contents.find("book info") == std::string::npos);
+    EXPECT_TRUE(contents.find("book warn") != std::string::npos);
+}
+
+TEST_F(SlickLoggerTest, PersistentAndInternedStrings) {
+    static const std::string venue = "XNAS";
+    auto symbol = slick::logger::intern(std::string("AAPL"));
+    EXPECT_EQ(symbol.value.data(), slick::logger::intern("AAPL").value.data());   // interned once
+    EXPECT_EQ(symbol.value, "AAPL");
+
+    std::filesystem::remove("test.log");
+    slick::logger::Logger::instance().init("test.log", 1024);
+    slick::logger::Logger::instance().set_level(slick::logger::LogLevel::L_TRACE);
+    LOG_INFO("Order {} on {} qty {:>5}", symbol, slick::logger::persistent(venue), 100);
+    LOG_INFO("Padded [{:<6}]", slick::logger::persistent(std::string_view(venue).substr(0, 2)));
+    slick::logger::Logger::instance().shutdown();
+
+    std::ifstream log_file("test.log");
+    std::string line;
+    std::getline(log_file, line);   // first line is the logger's version
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Order AAPL on XNAS qty   100") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Padded [XN    ]") != std::string::npos) << line;
+}
+
+TEST_F(SlickLoggerTest, BytesArguments) {
+    const uint8_t packet[] = { 'H', 'i', '!', 0x00, 0x7f, 0xab, 0xcd, 0xef, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80, 0x90, 'O', 'K' };
+
+    std::filesystem::remove("test.log");
+    slick::logger::Logger::instance().init("test.log", 1024);
+    slick::logger::Logger::instance().set_level(slick::logger::LogLevel::L_TRACE);
+    LOG_INFO("Raw {} end", slick::logger::bytes(packet, 4));
+    LOG_INFO("Upper {:X}", slick::logger::bytes(packet + 4, 4));
+    LOG_INFO("Packet{:dump}", slick::logger::bytes(packet, sizeof(packet)));
+    LOG_INFO("Bad {:d}", slick::logger::bytes(packet, 1));
+    slick::logger::Logger::instance().shutdown();
+
+    std::ifstream log_file("test.log");
+    std::string line;
+    std::getline(log_file, line);   // first line is the logger's version
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Raw 48692100 end") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Upper 7FABCDEF") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("] Packet") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_EQ(line, "00000000  48 69 21 00 7f ab cd ef  10 20 30 40 50 60 70 80  |Hi!...... 0@P`p.|");
+    std::getline(log_file, line);
+    EXPECT_EQ(line, "00000010  90 4f 4b                                          |.OK|");
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("FORMAT_ERROR") != std::string::npos) << line;
+}
+
+TEST_F(SlickLoggerTest, HexKernelMatchesScalarReference) {
+    std::vector<uint8_t> data(300);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 300}) {
+        for (bool upper : {false, true}) {
+            const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+            std::string expected = "prefix";
+            for (size_t i = 0; i < len; ++i) {
+                expected += digits[data[i] >> 4];
+                expected += digits[data[i] & 0xF];
+            }
+            std::string out = "prefix";
+            slick::logger::append_hex(out, data.data(), len, upper);
+            EXPECT_EQ(out, expected) << "len=" << len;
+        }
+    }
+}
+
+TEST_F(SlickLoggerTest, ArrayArguments) {
+    std::vector<double> prices{101.25, 101.5, 102.125};
+    std::array<int32_t, 3> sizes{100, -200, 300};
+    const uint16_t levels[] = {1, 2};
+    std::vector<float> empty;
+
+    std::filesystem::remove("test.log");
+    slick::logger::Logger::instance().init("test.log", 1024);
+    slick::logger::Logger::instance().set_level(slick::logger::LogLevel::L_TRACE);
+    LOG_INFO("Prices {::.2f}", prices);
+    LOG_INFO("Sizes {} levels {:n:#x}", sizes, levels);
+    LOG_INFO("Span {} empty {}", std::span<const int32_t>(sizes).subspan(1), empty);
+    LOG_INFO("Bad {:s}", sizes);
+    prices[0] = 0;  // values were copied at the call site
+    slick::logger::Logger::instance().shutdown();
+
+    std::ifstream log_file("test.log");
+    std::string line;
+    std::getline(log_file, line);   // first line is the logger's version
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Prices [101.25, 101.50, 102.12]") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Sizes [100, -200, 300] levels 0x1, 0x2") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Span [-200, 300] empty []") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("FORMAT_ERROR") != std::string::npos) << line;
+}
+
+TEST_F(SlickLoggerTest, ArgumentsLargerThanStringQueue) {
+    // A 64 byte string queue holds at most 63 bytes of one argument; the rest is dropped and marked
+    std::vector<int32_t> values(100);
+    for (int32_t i = 0; i < 100; ++i) {
+        values[i] = i;
+    }
+    std::vector<uint8_t> packet(100, 0xAB);
+    std::string text(100, 'x');
+
+    std::filesystem::remove("test.log");
+    auto log_once = [](auto&& log) {
+        slick::logger::Logger::instance().init("test.log", 1024, 64);
+        log();
+        slick::logger::Logger::instance().shutdown();
+    };
+    log_once([&] { LOG_INFO("Values {}", values); });
+    log_once([&] { LOG_INFO("Packet {}", slick::logger::bytes(packet.data(), packet.size())); });
+    log_once([&] { LOG_INFO("Text {}", text); });
+
+    std::ifstream log_file("test.log");
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(log_file, line)) {
+        if (line.find("SlickLogger v") == std::string::npos) {
+            lines.push_back(line);
+        }
+    }
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_TRUE(lines[0].find("Values [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, ...]") != std::string::npos) << lines[0];
+    std::string hex;
+    for (int i = 0; i < 63; ++i) {
+        hex += "ab";
+    }
+    EXPECT_TRUE(lines[1].find("Packet " + hex + "...") != std::string::npos) << lines[1];
+    EXPECT_TRUE(lines[2].find("Text " + std::string(63, 'x') + "...") != std::string::npos) << lines[2];
+}
+
+TEST_F(SlickLoggerTest, DecimalArguments) {
+    std::filesystem::remove("test.log");
+    slick::logger::Logger::instance().init("test.log", 1024);
+    slick::logger::Logger::instance().set_level(slick::logger::LogLevel::L_TRACE);
+    LOG_INFO("Px {} qty {}", slick::logger::decimal(10125, -2), slick::logger::decimal(15, 3));
+    LOG_INFO("Px {:.1f} [{:>8.4}]", slick::logger::decimal(-10125, -2), slick::logger::decimal(5, -3));
+    LOG_INFO("Bad {:.x}", slick::logger::decimal(1, 0));
+    LOG_INFO("Fill [{:.>10}] [{:*<8.1f}]", slick::logger::decimal(10125, -2), slick::logger::decimal(10125, -2));
+    LOG_INFO("Negative {:.-1}", slick::logger::decimal(1, 0));
+    LOG_INFO("Tiny [{:.2f}]", slick::logger::decimal(-4, -3));
+    slick::logger::Logger::instance().shutdown();
+
+    std::ifstream log_file("test.log");
+    std::string line;
+    std::getline(log_file, line);   // first line is the logger's version
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Px 101.25 qty 15000") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Px -101.3 [  0.0050]") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("FORMAT_ERROR") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Fill [....101.25] [101.3***]") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("FORMAT_ERROR") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Tiny [-0.00]") != std::string::npos) << line;
+}
+
+TEST_F(SlickLoggerTest, DecimalRendering) {
+    using slick::logger::decimal;
+    auto render = [](slick::logger::Decimal value, int precision = -1) {
+        std::string out;
+        slick::logger::append_decimal(out, value, precision);
+        return out;
+    };
+    EXPECT_EQ(render(decimal(0, 0)), "0");
+    EXPECT_EQ(render(decimal(0, -2)), "0.00");
+    EXPECT_EQ(render(decimal(7, -3)), "0.007");
+    EXPECT_EQ(render(decimal(-7, -3)), "-0.007");
+    EXPECT_EQ(render(decimal(123456, -2)), "1234.56");
+    EXPECT_EQ(render(decimal(12, 2)), "1200");
+    EXPECT_EQ(render(decimal(12, 2), 2), "1200.00");
+    EXPECT_EQ(render(decimal(9995, -3), 2), "10.00");
+    EXPECT_EQ(render(decimal(-9995, -3), 2), "-10.00");
+    EXPECT_EQ(render(decimal(-4, -3), 2), "-0.00");
+    EXPECT_EQ(render(decimal(-4, -3), 2), std::format("{:.2f}", -0.004));
+    EXPECT_EQ(render(decimal(-4, -3), 0), "-0");
+    EXPECT_EQ(render(decimal(15, -1), 0), "2");
+    EXPECT_EQ(render(decimal(1, -30), 2), "0.00");
+    EXPECT_EQ(render(decimal(INT64_MIN, 0)), "-9223372036854775808");
+    EXPECT_EQ(render(decimal(INT64_MAX, -18)), "9.223372036854775807");
+
+    // Agrees with floating point wherever the double is exact enough
+    for (int64_t mantissa = -2000; mantissa <= 2000; mantissa += 7) {
+        EXPECT_EQ(render(decimal(mantissa, -2)), std::format("{:.2f}", mantissa / 100.0)) << mantissa;
+    }
+}
+
+TEST_F(SlickLoggerTest, ThreadContextFields) {
+    std::filesystem::remove("test.log");
+    slick::logger::Logger::instance().init("test.log", 1024);
+    slick::logger::Logger::instance().set_level(slick::logger::LogLevel::L_TRACE);
+    {
+        slick::logger::ScopedContext strategy("strategy", "mm1");
+        LOG_INFO("Started");
+        {
+            slick::logger::ScopedContext order("order", 42);
+            slick::logger::ScopedContext strategy_override("strategy", "mm2");
+            LOG_INFO("Sent {}", 1);
+            std::thread([] { LOG_INFO("Other thread"); }).join();
+        }
+        LOG_INFO("Done");
+    }
+    LOG_INFO("No context");
+    slick::logger::Logger::instance().shutdown();
+
+    std::ifstream log_file("test.log");
+    std::string line;
+    std::getline(log_file, line);   // first line is the logger's version
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("[INFO] [strategy=mm1] Started") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("[INFO] [strategy=mm2 order=42] Sent 1") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("[INFO] Other thread") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("[INFO] [strategy=mm1] Done") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("[INFO] No context") != std::string::npos) << line;
+    EXPECT_EQ(slick::logger::current_context_id(), 0u);
+}
+
+TEST_F(SlickLoggerTest, ContextSnapshotsAreReclaimed) {
+    using slick::logger::ContextRegistry;
+    std::filesystem::remove("test.log");
+    slick::logger::Logger::instance().init("test.log", 1024);
+
+    // More distinct contexts than the registry holds, each released when its scope ends
+    for (uint32_t order = 0; order < ContextRegistry::CAPACITY + 100; ++order) {
+        slick::logger::ScopedContext context("order", order);
+        EXPECT_NE(slick::logger::current_context_id(), 0u);
+    }
+    EXPECT_LT(ContextRegistry::instance().size(), size_t(ContextRegistry::CAPACITY));
+    {
+        slick::logger::ScopedContext context("order", "last");
+        LOG_INFO("Reused slot");
+    }
+
+    // With every slot held by a live scope, a new scope logs without context instead of throwing
+    std::vector<std::unique_ptr<slick::logger::ScopedContext>> held;
+    while (held.size() < ContextRegistry::CAPACITY && (held.empty() || slick::logger::current_context_id() != 0)) {
+        held.push_back(std::make_unique<slick::logger::ScopedContext>("held", held.size()));
+    }
+    EXPECT_EQ(slick::logger::current_context_id(), 0u);
+    LOG_INFO("Registry full");
+    while (!held.empty()) {
+        held.pop_back();   // innermost scope first
+    }
+    {
+        slick::logger::ScopedContext context("order", 42);
+        EXPECT_NE(slick::logger::current_context_id(), 0u);
+    }
+    slick::logger::Logger::instance().shutdown();
+
+    std::ifstream log_file("test.log");
+    std::string line;
+    std::getline(log_file, line);   // first line is the logger's version
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("[INFO] [order=last] Reused slot") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("[INFO] Registry full") != std::string::npos) << line;
+}
+
+TEST_F(SlickLoggerTest, KeyValueArguments) {
+    std::filesystem::remove("test.log");
+    slick::logger::Logger::instance().init("test.log", 1024);
+    slick::logger::Logger::instance().set_level(slick::logger::LogLevel::L_TRACE);
+    int qty = 100;
+    std::string side = "BUY";
+    LOG_INFO("Order {} {:.2f}", slick::logger::kv("qty", qty), slick::logger::kv("px", 101.125));
+    LOG_INFO("Filled", slick::logger::kv("qty", qty), slick::logger::kv("side", side));
+    LOG_INFO("Sent {}", 7, slick::logger::kv("venue", "XNAS"));
+    slick::logger::Logger::instance().shutdown();
+
+    std::ifstream log_file("test.log");
+    std::string line;
+    std::getline(log_file, line);   // first line is the logger's version
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Order qty=100 px=101.12") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Filled qty=100 side=BUY") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("Sent 7 venue=XNAS") != std::string::npos) << line;
+}
+
+TEST_F(SlickLoggerTest, ThreadIdsAndNames) {
+    std::filesystem::remove("test.log");
+    slick::logger::Logger::instance().init("test.log", 1024);
+    slick::logger::Logger::instance().set_level(slick::logger::LogLevel::L_TRACE);
+    uint32_t main_id = slick::logger::current_thread_id();
+    uint32_t feed_id = 0;
+    std::thread([&feed_id] {
+        slick::logger::Logger::set_thread_name("md-feed-3");
+        feed_id = slick::logger::current_thread_id();
+        LOG_INFO("Tick {}", 1);
+    }).join();
+    EXPECT_NE(main_id, 0u);
+    EXPECT_NE(feed_id, 0u);
+    EXPECT_NE(main_id, feed_id);
+    EXPECT_EQ(slick::logger::current_thread_id(), main_id);
+    EXPECT_EQ(slick::logger::Logger::thread_name(feed_id), "md-feed-3");
+    LOG_INFO("Unnamed");
+    slick::logger::Logger::instance().shutdown();
+
+    std::ifstream log_file("test.log");
+    std::string line;
+    std::getline(log_file, line);   // first line is the logger's version
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("[INFO] [md-feed-3] Tick 1") != std::string::npos) << line;
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find("[INFO] Unnamed") != std::string::npos) << line;
+}
+
+TEST_F(SlickLoggerTest, BatchLogging) {
+    std::filesystem::remove("test.log");
+    slick::logger::Logger::instance().init("test.log", 1024);
+    slick::logger::Logger::instance().set_level(slick::logger::LogLevel::L_INFO);
+    EXPECT_THROW(slick::logger::Logger::instance().batch(4096), std::runtime_error);
+    {
+        auto batch = slick::logger::Logger::instance().batch(4);
+        EXPECT_EQ(batch.capacity(), 4u);
+        batch.log(slick::logger::LogLevel::L_INFO, "Level {} px {}", 0, 100.5);
+        batch.log(slick::logger::LogLevel::L_DEBUG, "Filtered");
+        // Logged from another thread while the batch is open, after the batch's entries
+        std::thread([] { LOG_INFO("Other thread"); }).join();
+        batch.log(slick::logger::LogLevel::L_INFO, "Level {} px {}", 1, std::string("100.25"));
+        EXPECT_EQ(batch.size(), 2u);
+    }
+    {
+        auto batch = slick::logger::Logger::instance().batch(1);
+        batch.log(slick::logger::LogLevel::L_WARN, "First");
+        batch.log(slick::logger::LogLevel::L_WARN, "Overflow");
+    }
+    slick::logger::Logger::instance().shutdown();
+
+    {
+        auto batch = slick::logger::Logger::instance().batch(2);
+        EXPECT_EQ(batch.capacity(), 0u);
+        batch.log(slick::logger::LogLevel::L_INFO, "Stopped");
+    }
+
+    std::ifstream log_file("test.log");
+    std::string line;
+    std::getline(log_file, line);   // first line is the logger's version
+    std::vector<std::string> lines;
+    while (std::getline(log_file, line)) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 5u);
+    EXPECT_TRUE(lines[0].find("Level 0 px 100.5") != std::string::npos) << lines[0];
+    EXPECT_TRUE(lines[1].find("Level 1 px 100.25") != std::string::npos) << lines[1];
+    EXPECT_TRUE(lines[2].find("Other thread") != std::string::npos) << lines[2];
+    EXPECT_TRUE(lines[3].find("First") != std::string::npos) << lines[3];
+    EXPECT_TRUE(lines[4].find("Overflow") != std::string::npos) << lines[4];
+}
+
+TEST_F(SlickLoggerTest, RestartWithoutBanner) {
+    std::filesystem::remove("test.log");
+    slick::logger::LogConfig config;
+    config.sinks.push_back(std::make_shared<slick::logger::FileSink>("test.log"));
+    config.log_queue_size = 1024;
+    config.version_banner = false;
+    slick::logger::Logger::instance().init(config);
+    LOG_INFO("First run");
+    slick::logger::Logger::instance().shutdown();
+
+    // Same sizes: the queues are reused and entries of the first run are not written again
+    config.sinks = {std::make_shared<slick::logger::FileSink>("test.log")};
+    slick::logger::Logger::instance().init(config);
+    LOG_INFO("Second run");
+    slick::logger::Logger::instance().shutdown();
+    slick::logger::Logger::instance().set_version_banner(true);
+
+    std::ifstream log_file("test.log");
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(log_file, line)) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_TRUE(lines[0].find("First run") != std::string::npos) << lines[0];
+    EXPECT_TRUE(lines[1].find("Second run") != std::string::npos) << lines[1];
+}
+
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -1,11 +1,19 @@
 #include <slick/logger.hpp>
 #include <gtest/gtest.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 #include <thread>
 #include <filesystem>
 #include <fstream>
 #include <string>
 #include <sstream>
 #include <chrono>
+#include <mutex>
+
+#ifdef SLICK_LOGGER_HAS_ZLIB
+#include <zlib.h>
+#endif
 
 class SinkTest : public ::testing::Test {
 protected:
@@ -27,7 +35,10 @@ protected:
             "daily_test.log", "daily_rotation_test.log", "daily_rotation_test_2025-08-25.log",
             "daily_size_test.log", "args_sink.log", "dedicated_sink.log", "filtered_sink.log",
             "named_sink1.log", "named_sink2.log", "regular_sink.log", "daily_no_size_rotation.log",
-            "daily_multi_rotation.log", "daily_restart_test.log", "daily_restart_existing.log"
+            "daily_multi_rotation.log", "daily_restart_test.log", "daily_restart_existing.log",
+            "compressed_test.log", "compressed_test_1.log.gz", "compressed_test_2.log.gz",
+            "json_lines_test.log", "flight_filtered.log", "flight_dump.log", "pattern_test.log",
+            "queue_memory_test.log"
         };
 
         for (const auto& file : files) {
@@ -45,7 +56,9 @@ protected:
                     filename.find("daily_no_size_rotation_") == 0 ||
                     filename.find("daily_multi_rotation_") == 0 ||
                     filename.find("daily_restart_test_") == 0 ||
-                    filename.find("daily_restart_existing_") == 0) {
+                    filename.find("daily_restart_existing_") == 0 ||
+                    filename.find("rotating_order") == 0 ||
+                    filename.find("daily_logtime") == 0) {
                     std::filesystem::remove(entry.path(), ec);
                 }
             }
@@ -54,9 +67,8 @@ protected:
 };
 
 TEST_F(SinkTest, ConsoleSinkBasic) {
-    // Redirect stdout to capture console output
-    std::stringstream buffer;
-    std::streambuf* old_cout = std::cout.rdbuf(buffer.rdbuf());
+    // Capture stdout at the file descriptor level (ConsoleSink bypasses iostreams)
+    testing::internal::CaptureStdout();
     
     slick::logger::Logger::instance().clear_sinks();
     slick::logger::Logger::instance().add_console_sink(false, false); // no colors, no stderr
@@ -66,14 +78,36 @@ TEST_F(SinkTest, ConsoleSinkBasic) {
     
     slick::logger::Logger::instance().reset();
     
-    // Restore stdout
-    std::cout.rdbuf(old_cout);
-    
-    std::string output = buffer.str();
+    std::string output = testing::internal::GetCapturedStdout();
     EXPECT_TRUE(output.find("Console test message") != std::string::npos);
     EXPECT_TRUE(output.find("[INFO]") != std::string::npos);
 }
 
+TEST_F(SinkTest, ConsoleSinkColorsAndStderrRouting) {
+    testing::internal::CaptureStdout();
+    testing::internal::CaptureStderr();
+
+    slick::logger::Logger::instance().clear_sinks();
+    slick::logger::Logger::instance().add_console_sink(true, true); // colors, warnings and above to stderr
+    slick::logger::Logger::instance().init(1024);
+
+    LOG_INFO("Console info line");
+    LOG_ERROR("Console error line");
+
+    slick::logger::Logger::instance().reset();
+
+    std::string out = testing::internal::GetCapturedStdout();
+    std::string err = testing::internal::GetCapturedStderr();
+
+    EXPECT_TRUE(out.find("\033[32m") != std::string::npos);
+    EXPECT_TRUE(out.find("Console info line\033[0m\n") != std::string::npos);
+    EXPECT_FALSE(out.find("Console error line") != std::string::npos);
+
+    EXPECT_TRUE(err.find("\033[31m") != std::string::npos);
+    EXPECT_TRUE(err.find("[ERROR] Console error line\033[0m\n") != std::string::npos);
+    EXPECT_FALSE(err.find("Console info line") != std::string::npos);
+}
+
 TEST_F(SinkTest, FileSinkBasic) {
     slick::logger::Logger::instance().clear_sinks();
     slick::logger::Logger::instance().add_file_sink("console_test.log");
@@ -92,10 +126,47 @@ TEST_F(SinkTest, FileSinkBasic) {
     EXPECT_TRUE(line.find("File sink test message") != std::string::npos);
 }
 
+TEST_F(SinkTest, FileSinkPatternLayout) {
+    EXPECT_THROW(slick::logger::PatternLayout("%Y %q"), std::runtime_error);
+
+    auto sink = std::make_shared<slick::logger::FileSink>("pattern_test.log", slick::logger::TimestampFormatter::Format::DEFAULT, "pattern");
+    sink->set_pattern("%F %T.%f|%e|%N <%l> [%t] %n {%X} %v 100%%");
+    slick::logger::Logger::instance().clear_sinks();
+    slick::logger::Logger::instance().add_sink(sink);
+    slick::logger::Logger::instance().init(1024);
+
+    std::thread([] {
+        slick::logger::Logger::set_thread_name("pattern-thread");
+        slick::logger::ScopedContext session("session", 7);
+        LOG_WARN("Value {}", 42);
+    }).join();
+    LOG_INFO("Bad {:d}", "text");
+
+    slick::logger::Logger::instance().reset();
+
+    std::ifstream log_file("pattern_test.log");
+    std::string line;
+    std::getline(log_file, line);   // first line is the logger's version
+    std::getline(log_file, line);
+    // 2024-08-26 15:30:45.123456|123|123456789 <WARN> ...
+    ASSERT_GT(line.size(), 40u) << line;
+    EXPECT_EQ(line[4], '-');
+    EXPECT_EQ(line[10], ' ');
+    EXPECT_EQ(line[13], ':');
+    EXPECT_EQ(line[19], '.');
+    EXPECT_EQ(line[26], '|');
+    EXPECT_EQ(line.substr(20, 3), line.substr(27, 3));
+    EXPECT_EQ(line.substr(20, 6), line.substr(31, 6));
+    EXPECT_EQ(line.substr(40), " <WARN> [pattern-thread] pattern {session=7} Value 42 100%") << line;
+
+    std::getline(log_file, line);
+    EXPECT_TRUE(line.find(" <ERROR> [") != std::string::npos) << line;
+    EXPECT_TRUE(line.find("] pattern {} ") != std::string::npos) << line;
+}
+
 TEST_F(SinkTest, MultiSinkTest) {
-    // Redirect stdout to capture console output
-    std::stringstream buffer;
-    std::streambuf* old_cout = std::cout.rdbuf(buffer.rdbuf());
+    // Capture stdout at the file descriptor level (ConsoleSink bypasses iostreams)
+    testing::internal::CaptureStdout();
     
     slick::logger::Logger::instance().clear_sinks();
     slick::logger::Logger::instance().add_console_sink(false, false);
@@ -109,11 +180,8 @@ TEST_F(SinkTest, MultiSinkTest) {
     
     slick::logger::Logger::instance().reset();
     
-    // Restore stdout
-    std::cout.rdbuf(old_cout);
-    
     // Check console output
-    std::string console_output = buffer.str();
+    std::string console_output = testing::internal::GetCapturedStdout();
     EXPECT_TRUE(console_output.find("Multi-sink test message") != std::string::npos);
     
     // Check file output
@@ -149,6 +217,418 @@ TEST_F(SinkTest, RotatingFileSinkTest) {
     EXPECT_TRUE(rotation_occurred);
 }
 
+#ifdef SLICK_LOGGER_HAS_ZLIB
+TEST_F(SinkTest, RotatingFileSinkCompressOld) {
+    slick::logger::RotationConfig rotation_config;
+    rotation_config.max_file_size = 100; // Very small for testing
+    rotation_config.max_files = 3;
+    rotation_config.compress_old = true;
+
+    slick::logger::Logger::instance().clear_sinks();
+    slick::logger::Logger::instance().add_rotating_file_sink("compressed_test.log", rotation_config);
+    slick::logger::Logger::instance().init(1024);
+
+    for (int i = 0; i < 20; ++i) {
+        LOG_INFO("Compression test message number {} with extra text to reach size limit", i);
+    }
+
+    // Destroying the sink drains its compression queue
+    slick::logger::Logger::instance().reset();
+
+    EXPECT_TRUE(std::filesystem::exists("compressed_test.log"));
+    ASSERT_TRUE(std::filesystem::exists("compressed_test_1.log.gz"));
+    EXPECT_FALSE(std::filesystem::exists("compressed_test_1.log"));
+    EXPECT_FALSE(std::filesystem::exists("compressed_test_1.log.gz.tmp"));
+
+    gzFile archive = gzopen("compressed_test_1.log.gz", "rb");
+    ASSERT_TRUE(archive != nullptr);
+    char buffer[4096];
+    int n = gzread(archive, buffer, sizeof(buffer));
+    gzclose(archive);
+    ASSERT_GT(n, 0);
+    std::string content(buffer, n);
+    EXPECT_TRUE(content.find("Compression test message number") != std::string::npos);
+}
+#endif
+
+TEST_F(SinkTest, RotatingFileSinkJanitorKeepsOrder) {
+    slick::logger::RotationConfig rotation_config;
+    rotation_config.max_file_size = 200;
+    rotation_config.max_files = 20; // Keep everything so ordering can be checked
+
+    slick::logger::Logger::instance().clear_sinks();
+    slick::logger::Logger::instance().add_rotating_file_sink("rotating_order.log", rotation_config);
+    slick::logger::Logger::instance().init(1024);
+
+    for (int i = 0; i < 30; ++i) {
+        LOG_INFO("Rotation order message {:03} with extra text to reach the size limit", i);
+    }
+
+    // Destroying the sink drains the janitor
+    slick::logger::Logger::instance().reset();
+
+    // Read files from oldest (highest index) to newest (base file)
+    std::vector<std::string> files;
+    for (int i = 19; i > 0; --i) {
+        auto name = "rotating_order_" + std::to_string(i) + ".log";
+        if (std::filesystem::exists(name)) {
+            files.push_back(name);
+        }
+    }
+    files.push_back("rotating_order.log");
+    ASSERT_GT(files.size(), 2u);
+
+    int expected = 0;
+    for (const auto& name : files) {
+        std::ifstream file(name);
+        std::string line;
+        while (std::getline(file, line)) {
+            auto pos = line.find("Rotation order message ");
+            if (pos != std::string::npos) {
+                EXPECT_EQ(std::stoi(line.substr(pos + 23, 3)), expected) << name;
+                ++expected;
+            }
+        }
+    }
+    EXPECT_EQ(expected, 30);
+
+    // No staged files left behind
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        EXPECT_EQ(entry.path().filename().string().find(".rotating"), std::string::npos);
+    }
+}
+
+TEST_F(SinkTest, JsonLinesSinkTypedArgs) {
+    slick::logger::Logger::instance().clear_sinks();
+    slick::logger::Logger::instance().add_json_lines_sink("json_lines_test.log");
+    slick::logger::Logger::instance().init(1024);
+
+    std::string symbol = "a \"quoted\" symbol name longer than sixteen bytes\twith tab";
+    LOG_INFO("Order {} qty {} px {:.2f} live {} sym {}", 42, -7, 101.25, true, symbol);
+    LOG_WARN("Plain message");
+    std::vector<double> fills{1.5, 2.25};
+    {
+        slick::logger::ScopedContext session("session", "S\"1");
+        LOG_INFO("Fills {} px {}", fills, slick::logger::decimal(10125, -2));
+    }
+    LOG_INFO("Order", slick::logger::kv("qty", 100), slick::logger::kv("sym", "AAPL"));
+    LOG_INFO("Clash", slick::logger::kv("level", 3), slick::logger::kv("message", "m"), slick::logger::kv("level", 4));
+
+    slick::logger::Logger::instance().reset();
+
+    std::ifstream file("json_lines_test.log");
+    std::string line;
+    std::getline(file, line);   // first line is the logger's version
+    std::getline(file, line);
+    EXPECT_EQ(line.find("{\"timestamp\":"), 0u);
+    EXPECT_TRUE(line.find(std::format(",\"thread\":{},", slick::logger::current_thread_id())) != std::string::npos) << line;
+    EXPECT_TRUE(line.find("\"level\":\"INFO\"") != std::string::npos);
+    EXPECT_TRUE(line.find("\"message\":\"Order 42 qty -7 px 101.25 live true sym a \\\"quoted\\\" symbol name longer than sixteen bytes\\twith tab\"") != std::string::npos) << line;
+    EXPECT_TRUE(line.find("\"args\":[42,-7,101.25,true,\"a \\\"quoted\\\" symbol name longer than sixteen bytes\\twith tab\"]}") != std::string::npos) << line;
+
+    std::getline(file, line);
+    EXPECT_TRUE(line.find("\"level\":\"WARN\",\"message\":\"Plain message\"}") != std::string::npos) << line;
+    EXPECT_TRUE(line.find("\"args\"") == std::string::npos);
+
+    std::getline(file, line);
+    EXPECT_TRUE(line.find("\"message\":\"Fills [1.5, 2.25] px 101.25\",\"context\":{\"session\":\"S\\\"1\"},\"args\":[[1.5,2.25],101.25]}") != std::string::npos) << line;
+    std::getline(file, line);
+    EXPECT_TRUE(line.find("\"message\":\"Order qty=100 sym=AAPL\",\"fields\":{\"qty\":100,\"sym\":\"AAPL\"}}") != std::string::npos) << line;
+
+    // Keys matching the entry's own members stay inside "fields", a repeated key only once
+    std::getline(file, line);
+    EXPECT_TRUE(line.find("\"level\":\"INFO\",\"message\":\"Clash level=3 message=m level=4\",\"fields\":{\"level\":3,\"message\":\"m\"}}") != std::string::npos) << line;
+}
+
+#ifndef _WIN32
+TEST_F(SinkTest, ShmRingSinkToReader) {
+    std::string shm_name = "/slick_logger_test_" + std::to_string(::getpid());
+    slick::logger::Logger::instance().clear_sinks();
+    slick::logger::Logger::instance().add_sink(std::make_shared<slick::logger::ShmRingSink>(shm_name, 65536, "shm", true));
+
+    // Attach before init so the version banner is the first record seen
+    slick::logger::ShmRingReader reader(shm_name, true);
+    slick::logger::Logger::instance().init(1024);
+    LOG_INFO("Shm message {}", 1);
+    LOG_ERROR("Shm message {}", 2);
+    slick::logger::Logger::instance().shutdown();
+
+    slick::logger::ShmRingReader::Record record;
+    ASSERT_TRUE(reader.read(record));   // version line
+    ASSERT_TRUE(reader.read(record));
+    EXPECT_EQ(record.message, "Shm message 1");
+    EXPECT_EQ(record.level, slick::logger::LogLevel::L_INFO);
+    EXPECT_GT(record.timestamp, 0u);
+    ASSERT_TRUE(reader.read(record));
+    EXPECT_EQ(record.message, "Shm message 2");
+    EXPECT_EQ(record.level, slick::logger::LogLevel::L_ERROR);
+    EXPECT_FALSE(reader.read(record));
+    EXPECT_EQ(reader.lost_bytes(), 0u);
+
+    slick::logger::Logger::instance().reset();
+}
+
+TEST_F(SinkTest, ShmRingWrapsAndDetectsOverrun) {
+    std::string shm_name = "/slick_logger_wrap_" + std::to_string(::getpid());
+    auto sink = std::make_shared<slick::logger::ShmRingSink>(shm_name, 4096, "shm", true);
+    slick::logger::ShmRingReader reader(shm_name);
+    slick::logger::ShmRingReader::Record record;
+
+    slick::logger::LogEntry entry{};
+    entry.level = slick::logger::LogLevel::L_INFO;
+
+    // A reader that keeps up sees every record across many wraps
+    std::vector<std::string> messages;
+    for (int i = 0; i < 500; ++i) {
+        messages.push_back("record " + std::to_string(i) + std::string(i % 37, '.'));
+    }
+    for (int i = 0; i < 500; ++i) {
+        entry.format_ptr = messages[i].c_str();
+        entry.timestamp = i;
+        sink->write(entry);
+        ASSERT_TRUE(reader.read(record));
+        EXPECT_EQ(record.message, messages[i]);
+        EXPECT_EQ(record.timestamp, static_cast<uint64_t>(i));
+    }
+    EXPECT_FALSE(reader.read(record));
+
+    // A reader that falls more than a ring behind skips ahead and reports the loss
+    for (int i = 0; i < 500; ++i) {
+        entry.format_ptr = messages[i].c_str();
+        sink->write(entry);
+    }
+    EXPECT_FALSE(reader.read(record));
+    EXPECT_GT(reader.lost_bytes(), 0u);
+    entry.format_ptr = "after overrun";
+    sink->write(entry);
+    ASSERT_TRUE(reader.read(record));
+    EXPECT_EQ(record.message, "after overrun");
+}
+
+TEST_F(SinkTest, ShmRingReaderFromOldestAfterWrap) {
+    std::string shm_name = "/slick_logger_oldest_" + std::to_string(::getpid());
+    auto sink = std::make_shared<slick::logger::ShmRingSink>(shm_name, 4096, "shm", true);
+
+    slick::logger::LogEntry entry{};
+    entry.level = slick::logger::LogLevel::L_INFO;
+    std::vector<std::string> messages;
+    for (int i = 0; i < 500; ++i) {
+        messages.push_back("record " + std::to_string(i) + std::string(i % 37, '.'));
+    }
+    for (int i = 0; i < 500; ++i) {
+        entry.format_ptr = messages[i].c_str();
+        entry.timestamp = i;
+        sink->write(entry);
+    }
+
+    // After many wraps the reader starts at an intact record and reads consecutively to the newest
+    slick::logger::ShmRingReader reader(shm_name, true);
+    slick::logger::ShmRingReader::Record record;
+    ASSERT_TRUE(reader.read(record));
+    uint64_t first = record.timestamp;
+    ASSERT_LT(first, 500u);
+    EXPECT_EQ(record.message, messages[first]);
+    for (uint64_t i = first + 1; i < 500; ++i) {
+        ASSERT_TRUE(reader.read(record));
+        EXPECT_EQ(record.timestamp, i);
+        EXPECT_EQ(record.message, messages[i]);
+    }
+    EXPECT_FALSE(reader.read(record));
+    EXPECT_EQ(reader.lost_bytes(), 0u);
+}
+#endif
+
+TEST_F(SinkTest, FlightRecorderDumpsRecentEntriesOnFatal) {
+    auto& logger = slick::logger::Logger::instance();
+    logger.clear_sinks();
+    logger.add_file_sink("flight_filtered.log", slick::logger::TimestampFormatter::Format::WITH_MICROSECONDS, "file");
+    logger.get_sink("file")->set_min_level(slick::logger::LogLevel::L_INFO);
+    auto recorder = std::make_shared<slick::logger::FlightRecorderSink>("flight_dump.log", 8, 4096);
+    logger.add_sink(recorder);
+    logger.init(1024);
+
+    for (int i = 0; i < 20; ++i) {
+        std::string detail = "detail-" + std::to_string(i);
+        LOG_TRACE("Trace {} {}", i, detail);
+    }
+    LOG_FATAL("Fatal error");
+    logger.shutdown();
+
+    std::ifstream filtered("flight_filtered.log");
+    std::string filtered_content((std::istreambuf_iterator<char>(filtered)), std::istreambuf_iterator<char>());
+    EXPECT_TRUE(filtered_content.find("Trace") == std::string::npos);
+
+    std::ifstream dump("flight_dump.log");
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(dump, line);) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 9u);
+    EXPECT_EQ(lines[0], "==== Flight recorder dump: 8 entries ====");
+    for (int i = 0; i < 7; ++i) {
+        std::string expected = "[TRACE] Trace " + std::to_string(13 + i) + " detail-" + std::to_string(13 + i);
+        EXPECT_TRUE(lines[1 + i].find(expected) != std::string::npos) << lines[1 + i];
+    }
+    EXPECT_TRUE(lines[8].find("[FATAL] Fatal error") != std::string::npos);
+    EXPECT_EQ(recorder->size(), 0u);
+
+    logger.reset();
+}
+
+TEST_F(SinkTest, FlightRecorderEvictsEntriesWhoseStringsWereOverwritten) {
+    slick::logger::FlightRecorderSink recorder("flight_dump.log", 64, 4096);
+    std::string big(600, 'x');
+
+    slick::logger::LogEntry entry{};
+    entry.level = slick::logger::LogLevel::L_DEBUG;
+    entry.format_ptr = "{}";
+    entry.arg_count = 1;
+    entry.args[0].type = slick::logger::ArgType::STRING_DYNAMIC;
+    for (int i = 0; i < 20; ++i) {
+        big[0] = static_cast<char>('a' + i);
+        entry.args[0].value.dynamic_str = slick::logger::StringRef{big.c_str(), static_cast<uint32_t>(big.size())};
+        recorder.write(entry);
+    }
+    // 4096 bytes hold at most six 601-byte strings, one less after wrapping past the arena end
+    EXPECT_GE(recorder.size(), 5u);
+    EXPECT_LE(recorder.size(), 6u);
+
+    big[0] = 'z';   // the recorder must hold its own copies
+    recorder.dump();
+    std::ifstream dump("flight_dump.log");
+    std::string content((std::istreambuf_iterator<char>(dump)), std::istreambuf_iterator<char>());
+    for (int i = 15; i < 20; ++i) {
+        EXPECT_TRUE(content.find("] " + std::string(1, static_cast<char>('a' + i)) + "xxx") != std::string::npos) << i;
+    }
+    EXPECT_TRUE(content.find("] nxxx") == std::string::npos);
+    EXPECT_TRUE(content.find("] zxxx") == std::string::npos);
+}
+
+namespace {
+class SlowCollectingSink : public slick::logger::ISink {
+public:
+    explicit SlowCollectingSink(std::chrono::microseconds delay) : delay_(delay) {}
+
+    void write(const slick::logger::LogEntry& entry) override {
+        std::this_thread::sleep_for(delay_);
+        std::string message;
+        format_log_message(entry, message);
+        std::lock_guard lock(mutex_);
+        messages_.push_back(std::move(message));
+    }
+    void flush() override {}
+
+    std::vector<std::string> messages() {
+        std::lock_guard lock(mutex_);
+        return messages_;
+    }
+
+private:
+    std::chrono::microseconds delay_;
+    std::mutex mutex_;
+    std::vector<std::string> messages_;
+};
+}
+
+TEST_F(SinkTest, AsyncSinkDeliversInOrderWhenBlocking) {
+    auto slow = std::make_shared<SlowCollectingSink>(std::chrono::microseconds(200));
+    auto async = std::make_shared<slick::logger::AsyncSink<SlowCollectingSink>>(slow, 4, slick::logger::AsyncOverflow::BLOCK, "async");
+
+    auto& logger = slick::logger::Logger::instance();
+    logger.clear_sinks();
+    logger.add_sink(async);
+    logger.init(1024);
+    for (int i = 0; i < 50; ++i) {
+        std::string tag = "tag" + std::to_string(i);
+        LOG_INFO("Async {} {}", i, tag);
+    }
+    logger.shutdown();
+    async.reset();  // drains the async queue
+
+    auto messages = slow->messages();
+    ASSERT_EQ(messages.size(), 51u);    // version line + 50 entries
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(messages[i + 1], "Async " + std::to_string(i) + " tag" + std::to_string(i));
+    }
+    logger.reset();
+}
+
+TEST_F(SinkTest, AsyncSinkCountsDrops) {
+    auto slow = std::make_shared<SlowCollectingSink>(std::chrono::milliseconds(5));
+    auto async = std::make_unique<slick::logger::AsyncSink<SlowCollectingSink>>(slow, 4, slick::logger::AsyncOverflow::DROP);
+
+    slick::logger::LogEntry entry{};
+    entry.level = slick::logger::LogLevel::L_INFO;
+    entry.format_ptr = "entry";
+    for (int i = 0; i < 100; ++i) {
+        async->write(entry);
+    }
+    uint64_t dropped = async->dropped();
+    async.reset();
+
+    EXPECT_GT(dropped, 0u);
+    EXPECT_EQ(slow->messages().size() + dropped, 100u);
+}
+
+TEST_F(SinkTest, AsyncSinkFiltersByInnerLevelBeforeQueueing) {
+    auto slow = std::make_shared<SlowCollectingSink>(std::chrono::microseconds(0));
+    slow->set_min_level(slick::logger::LogLevel::L_WARN);
+    auto async = std::make_unique<slick::logger::AsyncSink<SlowCollectingSink>>(slow, 4, slick::logger::AsyncOverflow::DROP);
+
+    slick::logger::LogEntry entry{};
+    entry.format_ptr = "entry";
+    entry.level = slick::logger::LogLevel::L_INFO;
+    for (int i = 0; i < 100; ++i) {
+        async->write(entry);    // filtered, never fills the queue
+    }
+    entry.level = slick::logger::LogLevel::L_WARN;
+    async->write(entry);
+    uint64_t dropped = async->dropped();
+    async.reset();
+
+    EXPECT_EQ(dropped, 0u);
+    EXPECT_EQ(slow->messages().size(), 1u);
+}
+
+TEST_F(SinkTest, JsonEscapingMatchesScalarReference) {
+    auto reference = [](std::string_view str) {
+        std::string out;
+        for (unsigned char c : str) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                default:
+                    if (c < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        out += buf;
+                    } else {
+                        out += static_cast<char>(c);
+                    }
+            }
+        }
+        return out;
+    };
+
+    // Special characters at every offset of strings spanning several SIMD blocks, plus UTF-8 bytes
+    for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 100}) {
+        for (char special : {'"', '\\', '\n', '\x01', '\x1f', '\xc3'}) {
+            for (size_t pos = 0; pos < len; ++pos) {
+                std::string input(len, 'x');
+                input[pos] = special;
+                std::string out;
+                slick::logger::append_json_escaped(out, input);
+                ASSERT_EQ(out, reference(input)) << "len=" << len << " pos=" << pos;
+            }
+        }
+    }
+}
+
 TEST_F(SinkTest, DailyFileSinkTest) {
     slick::logger::RotationConfig daily_config;
     
@@ -176,24 +656,18 @@ TEST_F(SinkTest, DailyFileSinkRotation) {
     class TestDailyFileSink : public slick::logger::DailyFileSink {
     public:
         TestDailyFileSink(const std::filesystem::path& base_path, const slick::logger::RotationConfig& config)
-            : DailyFileSink(base_path, config), test_date_("2025-08-25")
+            : DailyFileSink(base_path, config)
         {
-            current_date_ = test_date_;
-        }
-        
-        // Override to return our controlled test date
-        std::string get_date_string() const override {
-            return test_date_;
+            current_date_ = "2025-08-25";
+            next_rotation_ns_ = UINT64_MAX; // Stay on "day 1" until told otherwise
         }
         
-        // Method to change the date and trigger rotation check
-        void change_date_and_check(const std::string& new_date) {
-            test_date_ = new_date;
-            check_rotation(); // This should trigger rotation when date changes
+        // Make "day 1" end now and trigger rotation check
+        void end_day_and_check() {
+            uint64_t now = now_ns();
+            next_rotation_ns_ = now;
+            check_rotation(now); // This should trigger rotation when date changes
         }
-        
-    private:
-        std::string test_date_;
     };
     
     slick::logger::RotationConfig daily_config;
@@ -224,8 +698,8 @@ TEST_F(SinkTest, DailyFileSinkRotation) {
     // At this point, no dated file should exist yet
     EXPECT_FALSE(std::filesystem::exists("daily_rotation_test_2025-08-25.log"));
     
-    // Now simulate the next day by changing the date and triggering rotation check
-    test_sink->change_date_and_check("2025-08-26");
+    // Now simulate the next day by ending day 1 and triggering rotation check
+    test_sink->end_day_and_check();
     
     // After rotation check, the dated file should be created with day 1's content
     EXPECT_TRUE(std::filesystem::exists("daily_rotation_test_2025-08-25.log"));
@@ -270,6 +744,57 @@ TEST_F(SinkTest, DailyFileSinkRotation) {
     EXPECT_FALSE(final_base_content.find("Message from day 1") != std::string::npos);
 }
 
+TEST_F(SinkTest, DailyFileSinkRotatesOnLogTime) {
+    slick::logger::RotationConfig config;
+    config.max_file_size = 0;
+    auto sink = std::make_shared<slick::logger::DailyFileSink>("daily_logtime.log", config);
+
+    auto to_ns = [](std::tm tm) {
+        tm.tm_isdst = -1;
+        return static_cast<uint64_t>(std::mktime(&tm)) * 1000000000ULL;
+    };
+    auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm today = *std::localtime(&now);
+    char today_str[11];
+    std::strftime(today_str, sizeof(today_str), "%Y-%m-%d", &today);
+
+    std::tm late_today = today;
+    late_today.tm_hour = 23;
+    late_today.tm_min = 59;
+    late_today.tm_sec = 59;
+    std::tm early_tomorrow = today;
+    early_tomorrow.tm_mday += 1;
+    early_tomorrow.tm_hour = 0;
+    early_tomorrow.tm_min = 0;
+    early_tomorrow.tm_sec = 1;
+
+    slick::logger::LogEntry entry{};
+    entry.level = slick::logger::LogLevel::L_INFO;
+    entry.format_ptr = "Last entry of today";
+    entry.timestamp = to_ns(late_today);
+    sink->write(entry);
+    sink->flush();
+
+    std::string dated_file = std::string("daily_logtime_") + today_str + ".log";
+    EXPECT_FALSE(std::filesystem::exists(dated_file));
+
+    // An entry stamped after midnight rotates, regardless of the wall clock
+    entry.format_ptr = "First entry of tomorrow";
+    entry.timestamp = to_ns(early_tomorrow);
+    sink->write(entry);
+    sink.reset();
+
+    ASSERT_TRUE(std::filesystem::exists(dated_file));
+    std::ifstream dated(dated_file);
+    std::string dated_content((std::istreambuf_iterator<char>(dated)), std::istreambuf_iterator<char>());
+    EXPECT_TRUE(dated_content.find("Last entry of today") != std::string::npos);
+    EXPECT_FALSE(dated_content.find("First entry of tomorrow") != std::string::npos);
+
+    std::ifstream base("daily_logtime.log");
+    std::string base_content((std::istreambuf_iterator<char>(base)), std::istreambuf_iterator<char>());
+    EXPECT_TRUE(base_content.find("First entry of tomorrow") != std::string::npos);
+}
+
 TEST_F(SinkTest, DailyFileSinkSizeRotation) {
     slick::logger::RotationConfig size_config;
     size_config.max_file_size = 200; // Very small size for testing
@@ -358,9 +883,8 @@ TEST_F(SinkTest, LogConfigTest) {
     config.min_level = slick::logger::LogLevel::L_WARN;
     config.log_queue_size = 2048;
     
-    // Redirect stdout
-    std::stringstream buffer;
-    std::streambuf* old_cout = std::cout.rdbuf(buffer.rdbuf());
+    // Capture stdout at the file descriptor level (ConsoleSink bypasses iostreams)
+    testing::internal::CaptureStdout();
     
     slick::logger::Logger::instance().init(config);
     
@@ -370,10 +894,7 @@ TEST_F(SinkTest, LogConfigTest) {
     
     slick::logger::Logger::instance().reset();
     
-    // Restore stdout
-    std::cout.rdbuf(old_cout);
-    
-    std::string console_output = buffer.str();
+    std::string console_output = testing::internal::GetCapturedStdout();
     EXPECT_TRUE(console_output.find("This warning should appear") != std::string::npos);
     EXPECT_TRUE(console_output.find("This error should appear") != std::string::npos);
     EXPECT_FALSE(console_output.find("This should not appear") != std::string::npos);
@@ -387,6 +908,27 @@ TEST_F(SinkTest, LogConfigTest) {
     EXPECT_FALSE(file_content.find("This should not appear") != std::string::npos);
 }
 
+TEST_F(SinkTest, LogConfigQueueMemory) {
+    std::filesystem::remove("queue_memory_test.log");
+    slick::logger::LogConfig config;
+    config.sinks.push_back(std::make_shared<slick::logger::FileSink>("queue_memory_test.log"));
+    config.log_queue_size = 1 << 16;
+    config.string_buffer_size = 1 << 24;
+    config.huge_pages = true;
+    config.prefault_queues = true;
+    config.lock_queues = true;     // may fail without privileges, which only adds a warning
+    config.numa_node = 0;
+
+    slick::logger::Logger::instance().init(config);
+    LOG_INFO("Logged to prefaulted queues {}", std::string("after init"));
+    slick::logger::Logger::instance().reset();
+
+    std::ifstream log_file("queue_memory_test.log");
+    std::string file_content((std::istreambuf_iterator<char>(log_file)),
+                             std::istreambuf_iterator<char>());
+    EXPECT_TRUE(file_content.find("Logged to prefaulted queues after init") != std::string::npos);
+}
+
 TEST_F(SinkTest, NamedSinkDirectLogging) {
     // Test the new ISink::log() methods for direct selective logging
     slick::logger::Logger::instance().clear_sinks();
@@ -555,6 +1097,149 @@ TEST_F(SinkTest, DedicatedSinkTest) {
     EXPECT_TRUE(regular_content.find("Broadcast message to regular sinks only") != std::string::npos);
 }
 
+TEST_F(SinkTest, SinkMaskRouting) {
+    auto& logger = slick::logger::Logger::instance();
+    logger.clear_sinks();
+    logger.add_file_sink("named_sink1.log", "sink1");
+    logger.add_file_sink("named_sink2.log", "sink2");
+    auto dedicated_sink = std::make_shared<slick::logger::FileSink>("dedicated_sink.log", slick::logger::TimestampFormatter::Format::WITH_MICROSECONDS, "dedicated");
+    dedicated_sink->set_dedicated(true);
+    logger.add_sink(dedicated_sink);
+    logger.init(1024);
+
+    // One entry reaches a subset of sinks, including a dedicated one
+    logger.log_to_sinks(logger.sink_mask({"sink2", "dedicated"}), slick::logger::LogLevel::L_INFO, "To sink2 and dedicated {}", 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // Level changes at runtime are picked up by the routing tables
+    logger.get_sink("sink2")->set_min_level(slick::logger::LogLevel::L_WARN);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    LOG_INFO("Broadcast info");
+    LOG_WARN("Broadcast warn");
+    logger.log_to_sinks(logger.sink_mask({"sink2"}), slick::logger::LogLevel::L_INFO, "Filtered out for sink2");
+    logger.reset();
+
+    auto read_file = [](const char* path) {
+        std::ifstream file(path);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    std::string sink1 = read_file("named_sink1.log");
+    std::string sink2 = read_file("named_sink2.log");
+    std::string dedicated = read_file("dedicated_sink.log");
+
+    EXPECT_TRUE(sink1.find("To sink2 and dedicated") == std::string::npos);
+    EXPECT_TRUE(sink2.find("To sink2 and dedicated 1") != std::string::npos);
+    EXPECT_TRUE(dedicated.find("To sink2 and dedicated 1") != std::string::npos);
+
+    EXPECT_TRUE(sink1.find("Broadcast info") != std::string::npos);
+    EXPECT_TRUE(sink1.find("Broadcast warn") != std::string::npos);
+    EXPECT_TRUE(sink2.find("Broadcast info") == std::string::npos);
+    EXPECT_TRUE(sink2.find("Broadcast warn") != std::string::npos);
+    EXPECT_TRUE(sink2.find("Filtered out for sink2") == std::string::npos);
+    EXPECT_TRUE(dedicated.find("Broadcast") == std::string::npos);
+}
+
+TEST_F(SinkTest, AddRemoveSinksWhileRunning) {
+    auto& logger = slick::logger::Logger::instance();
+    logger.clear_sinks();
+    logger.add_file_sink("named_sink1.log", "sink1");
+    logger.init(65536);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> logged{0};
+    std::thread producer([&]() {
+        while (!stop.load()) {
+            LOG_INFO("Live message {}", logged.fetch_add(1));
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    });
+
+    for (int round = 0; round < 20; ++round) {
+        logger.add_file_sink("named_sink2.log", "sink2");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        EXPECT_TRUE(logger.remove_sink("sink2"));
+    }
+    EXPECT_FALSE(logger.remove_sink("sink2"));
+    EXPECT_EQ(logger.get_sink("sink2"), nullptr);
+
+    // After remove_sink returns the sink receives nothing more
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    auto size_after_remove = std::filesystem::file_size("named_sink2.log");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(std::filesystem::file_size("named_sink2.log"), size_after_remove);
+
+    stop.store(true);
+    producer.join();
+    logger.reset();
+
+    std::ifstream file("named_sink1.log");
+    int lines = 0;
+    for (std::string line; std::getline(file, line);) {
+        ++lines;
+    }
+    EXPECT_EQ(lines, logged.load() + 1);   // every message plus the version line
+    EXPECT_GT(std::filesystem::file_size("named_sink2.log"), 0u);
+}
+
+TEST_F(SinkTest, ClearSinksKeepsSinkBitsUntilReset) {
+    slick::logger::Logger logger;
+    auto first = std::make_shared<SlowCollectingSink>(std::chrono::microseconds(0));
+    logger.add_sink(first);
+    EXPECT_EQ(first->index(), 0);
+
+    logger.clear_sinks();
+    EXPECT_EQ(first->index(), -1);
+    EXPECT_EQ(first->logger(), nullptr);
+
+    // Queued entries may still target bit 0, so a new sink gets a fresh bit
+    auto second = std::make_shared<SlowCollectingSink>(std::chrono::microseconds(0));
+    logger.add_sink(second);
+    EXPECT_EQ(second->index(), 1);
+
+    // reset() drops the queues, after which the bits are handed out again
+    logger.reset();
+    EXPECT_EQ(second->logger(), nullptr);
+    logger.add_sink(first);
+    EXPECT_EQ(first->index(), 0);
+}
+
+TEST_F(SinkTest, IndependentLoggerInstances) {
+    using slick::logger::LogLevel;
+    auto recorder_sink = std::make_shared<slick::logger::FileSink>("named_sink1.log");
+    auto gateway_sink = std::make_shared<slick::logger::FileSink>("named_sink2.log");
+
+    {
+        slick::logger::Logger recorder;
+        slick::logger::Logger gateway;
+        recorder.add_sink(recorder_sink);
+        gateway.add_sink(gateway_sink);
+        EXPECT_THROW(gateway.add_sink(recorder_sink), std::runtime_error);
+        EXPECT_EQ(recorder_sink->logger(), &recorder);
+
+        recorder.init(1024);
+        gateway.init(256);
+        recorder.log(LogLevel::L_INFO, "Recorder message {}", 1);
+        gateway.log(LogLevel::L_INFO, "Gateway message {}", 2);
+        gateway_sink->log_warn("Gateway direct message");  // goes through the owning logger
+        auto& category = gateway.category("gateway.session");
+        LOG_CAT_INFO(category, "Gateway category message");
+    }
+    EXPECT_EQ(recorder_sink->logger(), nullptr);
+
+    auto read_file = [](const char* path) {
+        std::ifstream file(path);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    std::string recorder_log = read_file("named_sink1.log");
+    std::string gateway_log = read_file("named_sink2.log");
+    EXPECT_TRUE(recorder_log.find("Recorder message 1") != std::string::npos);
+    EXPECT_TRUE(recorder_log.find("Gateway") == std::string::npos);
+    EXPECT_TRUE(gateway_log.find("Gateway message 2") != std::string::npos);
+    EXPECT_TRUE(gateway_log.find("Gateway direct message") != std::string::npos);
+    EXPECT_TRUE(gateway_log.find("Gateway category message") != std::string::npos);
+    EXPECT_TRUE(gateway_log.find("Recorder") == std::string::npos);
+}
+
 TEST_F(SinkTest, DailyFileSinkNoSizeRotationWhenZero) {
     // Test that size-based rotation is disabled when max_file_size is set to 0
     slick::logger::RotationConfig config;
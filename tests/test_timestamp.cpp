@@ -115,6 +115,37 @@ TEST_F(TimestampTest, FileSinkWithDifferentTimestampFormats) {
     std::filesystem::remove("test_custom.log");
 }
 
+TEST_F(TimestampTest, CompiledLayoutMatchesTimestampFormatter) {
+    // Sinks compile their timestamp format into cached date ops; the text must not change
+    LogEntry entry;
+    entry.level = LogLevel::L_INFO;
+    entry.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    entry.format_ptr = "Test message";
+    entry.arg_count = 0;
+
+    std::vector<TimestampFormatter> formatters = {
+        TimestampFormatter(TimestampFormatter::Format::DEFAULT),
+        TimestampFormatter(TimestampFormatter::Format::WITH_MICROSECONDS),
+        TimestampFormatter(TimestampFormatter::Format::WITH_MILLISECONDS),
+        TimestampFormatter(TimestampFormatter::Format::ISO8601),
+        TimestampFormatter(TimestampFormatter::Format::TIME_ONLY),
+        TimestampFormatter(std::string("%d %b %Y %H:%M:%S %%")),
+    };
+    for (const auto& formatter : formatters) {
+        {
+            auto sink = formatter.format() == TimestampFormatter::Format::CUSTOM
+                ? std::make_unique<FileSink>("test_timestamps.log", formatter.custom_format())
+                : std::make_unique<FileSink>("test_timestamps.log", formatter.format());
+            sink->write(entry);
+            sink->flush();
+        }
+        std::string line = read_first_line("test_timestamps.log");
+        EXPECT_EQ(line, formatter.format_timestamp(entry.timestamp) + " [INFO] Test message");
+        std::filesystem::remove("test_timestamps.log");
+    }
+}
+
 TEST_F(TimestampTest, ConsoleSinkWithTimestampFormats) {
     // Test that console sink constructors work with different timestamp formats
     EXPECT_NO_THROW({